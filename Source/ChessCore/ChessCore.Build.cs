@@ -0,0 +1,15 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+
+public class ChessCore : ModuleRules
+{
+	public ChessCore(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		// Rules, hashing and search only. Keep this module free of UObject so it can be
+		// linked into Program targets and tools without booting the engine.
+		PublicDependencyModuleNames.AddRange(new string[] { "Core", "TraceLog" });
+	}
+}
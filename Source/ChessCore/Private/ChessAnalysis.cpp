@@ -0,0 +1,182 @@
+#include "ChessAnalysis.h"
+#include "ChessMoveGenerator.h"
+#include "Async/Async.h"
+#include "HAL/PlatformProcess.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+FChessAnalysisService::FChessAnalysisService(const FChessAnalysisSettings& InSettings)
+	: Settings(InSettings)
+	, Cache(FMath::Max(1, InSettings.CacheSize))
+{
+	Search.SetHashSizeMB(Settings.HashSizeMB);
+
+	// Auto-reset: one trigger wakes the worker once, however many requests arrived meanwhile.
+	WorkAvailable = FPlatformProcess::GetSynchEventFromPool(false);
+
+	// Below normal priority so the search never competes with the game and render threads.
+	WorkerTask = AsyncThread([this]() { WorkerLoop(); }, 0, TPri_BelowNormal);
+}
+
+FChessAnalysisService::~FChessAnalysisService()
+{
+	{
+		FScopeLock Lock(&RequestLock);
+		bShutdown = true;
+		PendingRequest.Reset();
+		Search.Stop();
+	}
+	WorkAvailable->Trigger();
+
+	// The search checks its stop flag every node, so this is one node's wait at most.
+	WorkerTask.Wait();
+	FPlatformProcess::ReturnSynchEventToPool(WorkAvailable);
+	WorkAvailable = nullptr;
+}
+
+void FChessAnalysisService::Analyze(const FChessPosition& Position, const TArray<uint64>& History)
+{
+	bool bFullyCached = false;
+	{
+		FScopeLock Lock(&CacheLock);
+		const FChessAnalysis* Cached = Cache.FindAndTouch(Position.GetHash());
+		bFullyCached = Cached && Cached->Depth >= Settings.MaxDepth;
+	}
+
+	FChessMoveList RootMoves;
+	if (!bFullyCached)
+		FChessMoveGenerator::GenerateLegal(Position, RootMoves);
+
+	if (RootMoves.Num() == 0)
+	{
+		Stop();
+		return;
+	}
+
+	{
+		FScopeLock Lock(&RequestLock);
+		PendingRequest.Emplace(FRequest{ Position, History });
+		Search.Stop();
+	}
+	WorkAvailable->Trigger();
+}
+
+void FChessAnalysisService::Stop()
+{
+	FScopeLock Lock(&RequestLock);
+	PendingRequest.Reset();
+	Search.Stop();
+}
+
+void FChessAnalysisService::WorkerLoop()
+{
+	for (;;)
+	{
+		WorkAvailable->Wait();
+
+		// Drain: a request that arrives during a search is picked up as soon as it unwinds.
+		for (;;)
+		{
+			FRequest Request;
+			{
+				FScopeLock Lock(&RequestLock);
+				bSearching = false;
+				if (bShutdown)
+					return;
+				if (!PendingRequest.IsSet())
+					break;
+
+				Request = MoveTemp(PendingRequest.GetValue());
+				PendingRequest.Reset();
+
+				if (bClearHashPending)
+				{
+					Search.ClearHash();
+					bClearHashPending = false;
+				}
+
+				Search.BeginSearch();
+				bSearching = true;
+			}
+
+			RunRequest(Request);
+		}
+	}
+}
+
+void FChessAnalysisService::RunRequest(const FRequest& Request)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FChessAnalysisService::Search);
+
+	FChessMoveList RootMoves;
+	FChessMoveGenerator::GenerateLegal(Request.Position, RootMoves);
+
+	FChessSearchLimits Limits;
+	Limits.Depth = Settings.MaxDepth;
+	Limits.MultiPV = FMath::Max(1, Settings.MultiPV);
+	const int32 NumLines = FMath::Min(Limits.MultiPV, RootMoves.Num());
+
+	FChessAnalysis Analysis;
+	Analysis.Hash = Request.Position.GetHash();
+	Analysis.SideToMove = Request.Position.GetSideToMove();
+
+	// The table is kept between positions, so re-searching a shallow cache entry is quick.
+	Search.Search(Request.Position, Request.History, Limits, [this, &Analysis, NumLines](const FChessSearchInfo& Info)
+		{
+			if (Info.MultiPVIndex == 1)
+				Analysis.Lines.Reset();
+
+			FChessSearchLine& Line = Analysis.Lines.AddDefaulted_GetRef();
+			Line.Score = Info.Score;
+			Line.PrincipalVariation = Info.PrincipalVariation;
+
+			// Publish whole iterations only, so the overlay never mixes depths.
+			if (Analysis.Lines.Num() == NumLines)
+			{
+				Analysis.Depth = Info.Depth;
+				Publish(Analysis);
+			}
+		});
+}
+
+void FChessAnalysisService::Publish(const FChessAnalysis& Analysis)
+{
+	FChessAnalysis Sorted = Analysis;
+	Sorted.Lines.StableSort([](const FChessSearchLine& A, const FChessSearchLine& B) { return A.Score > B.Score; });
+
+	FScopeLock Lock(&CacheLock);
+	const FChessAnalysis* Cached = Cache.Find(Analysis.Hash);
+	if (!Cached || Cached->Depth <= Sorted.Depth)
+		Cache.Add(Analysis.Hash, MoveTemp(Sorted));
+}
+
+bool FChessAnalysisService::GetAnalysis(uint64 Hash, FChessAnalysis& OutAnalysis, int32 NewerThanDepth) const
+{
+	FScopeLock Lock(&CacheLock);
+	const FChessAnalysis* Cached = Cache.Find(Hash);
+	if (!Cached || Cached->Depth <= NewerThanDepth)
+		return false;
+
+	OutAnalysis = *Cached;
+	return true;
+}
+
+bool FChessAnalysisService::IsAnalyzing() const
+{
+	FScopeLock Lock(&RequestLock);
+	return PendingRequest.IsSet() || bSearching;
+}
+
+void FChessAnalysisService::ClearCache()
+{
+	{
+		FScopeLock Lock(&RequestLock);
+		PendingRequest.Reset();
+		Search.Stop();
+
+		// The worker may still be inside the search; it clears the table before its next one.
+		bClearHashPending = true;
+	}
+
+	FScopeLock Lock(&CacheLock);
+	Cache.Empty(FMath::Max(1, Settings.CacheSize));
+}
@@ -0,0 +1,39 @@
+#include "ChessCoreTypes.h"
+
+FString ChessSquare::ToString(int32 Square)
+{
+	if (Square < 0 || Square >= 64)
+		return TEXT("-");
+
+	FString Result;
+	Result.AppendChar(TEXT('a') + Col(Square));
+	Result.AppendChar(TEXT('1') + Row(Square));
+	return Result;
+}
+
+int32 ChessSquare::FromString(const FString& Text)
+{
+	if (Text.Len() < 2)
+		return None;
+
+	const int32 C = Text[0] - TEXT('a');
+	const int32 R = Text[1] - TEXT('1');
+	return IsOnBoard(R, C) ? Make(R, C) : None;
+}
+
+FString FChessMove::ToUci() const
+{
+	if (IsNull())
+		return TEXT("0000");
+
+	FString Result = ChessSquare::ToString(From) + ChessSquare::ToString(To);
+	switch (Promotion)
+	{
+	case EChessPieceType::Queen:  Result.AppendChar(TEXT('q')); break;
+	case EChessPieceType::Rook:   Result.AppendChar(TEXT('r')); break;
+	case EChessPieceType::Bishop: Result.AppendChar(TEXT('b')); break;
+	case EChessPieceType::Knight: Result.AppendChar(TEXT('n')); break;
+	default: break;
+	}
+	return Result;
+}
@@ -0,0 +1,140 @@
+#include "ChessMatch.h"
+#include "ChessMoveGenerator.h"
+
+FChessMatch::FChessMatch()
+{
+	Reset();
+}
+
+void FChessMatch::Reset()
+{
+	verify(ResetFromFen(FChessPosition::StartFen));
+}
+
+bool FChessMatch::ResetFromFen(const FString& Fen)
+{
+	if (!Position.SetFromFen(Fen))
+		return false;
+
+	Records.Reset();
+	HashHistory.Reset();
+	UpdateStatus();
+	return true;
+}
+
+void FChessMatch::GetLegalMoves(FChessMoveList& OutMoves) const
+{
+	FChessMoveGenerator::GenerateLegal(Position, OutMoves);
+}
+
+void FChessMatch::GetLegalMovesFrom(int32 Square, FChessMoveList& OutMoves) const
+{
+	FChessMoveGenerator::GenerateLegalFrom(Position, Square, OutMoves);
+}
+
+bool FChessMatch::FindLegalMove(int32 From, int32 To, FChessMove& OutMove, EChessPieceType Promotion) const
+{
+	FChessMoveList Moves;
+	GetLegalMovesFrom(From, Moves);
+	for (const FChessMove& Move : Moves)
+	{
+		if (Move.To == To && (!Move.IsPromotion() || Move.Promotion == Promotion))
+		{
+			OutMove = Move;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool FChessMatch::MakeMove(const FChessMove& Move)
+{
+	// Draw claims (repetition, fifty moves) do not stop play here; front ends decide whether to honour them.
+	// Re-resolve against the legal list so flags always come from this position.
+	FChessMove Legal;
+	if (!FindLegalMove(Move.From, Move.To, Legal, Move.IsPromotion() ? Move.Promotion : EChessPieceType::Queen))
+		return false;
+
+	HashHistory.Add(Position.GetHash());
+	FRecord& Record = Records.AddDefaulted_GetRef();
+	Record.Move = Legal;
+	Position.MakeMove(Legal, Record.Undo);
+
+	UpdateStatus();
+	return true;
+}
+
+bool FChessMatch::UndoMove()
+{
+	if (Records.Num() == 0)
+		return false;
+
+	const FRecord Record = Records.Pop();
+	HashHistory.Pop();
+	Position.UnmakeMove(Record.Move, Record.Undo);
+
+	UpdateStatus();
+	return true;
+}
+
+void FChessMatch::UpdateStatus()
+{
+	FChessMoveList Moves;
+	GetLegalMoves(Moves);
+	if (Moves.Num() == 0)
+	{
+		Status = IsInCheck() ? EChessGameStatus::Checkmate : EChessGameStatus::Stalemate;
+		return;
+	}
+
+	if (Position.GetHalfmoveClock() >= 100)
+	{
+		Status = EChessGameStatus::FiftyMoveRule;
+		return;
+	}
+
+	// Threefold: the current position plus two earlier ones since the last irreversible move.
+	int32 Repeats = 0;
+	const int32 First = FMath::Max(0, HashHistory.Num() - Position.GetHalfmoveClock());
+	for (int32 i = HashHistory.Num() - 2; i >= First; i -= 2)
+		if (HashHistory[i] == Position.GetHash())
+			++Repeats;
+	if (Repeats >= 2)
+	{
+		Status = EChessGameStatus::Repetition;
+		return;
+	}
+
+	Status = HasInsufficientMaterial() ? EChessGameStatus::InsufficientMaterial : EChessGameStatus::InProgress;
+}
+
+bool FChessMatch::HasInsufficientMaterial() const
+{
+	// Bare kings, a single minor piece, or only bishops that all stand on one square colour.
+	int32 Knights = 0;
+	int32 Bishops = 0;
+	int32 BishopSquareColors = 0;
+	for (int32 Square = 0; Square < 64; ++Square)
+	{
+		const FChessPiece& Piece = Position.GetPiece(Square);
+		switch (Piece.Type)
+		{
+		case EChessPieceType::None:
+		case EChessPieceType::King:
+			break;
+		case EChessPieceType::Knight:
+			++Knights;
+			break;
+		case EChessPieceType::Bishop:
+			++Bishops;
+			BishopSquareColors |= 1 << ((ChessSquare::Row(Square) + ChessSquare::Col(Square)) & 1);
+			break;
+		default:
+			return false;
+		}
+	}
+
+	if (Knights + Bishops <= 1)
+		return true;
+	return Knights == 0 && BishopSquareColors != 3;
+}
@@ -0,0 +1,266 @@
+#include "ChessMoveGenerator.h"
+
+namespace
+{
+	const int32 KnightOffsets[8][2] = { {2,1},{1,2},{-1,2},{-2,1},{-2,-1},{-1,-2},{1,-2},{2,-1} };
+	const int32 KingOffsets[8][2] = { {1,0},{-1,0},{0,1},{0,-1},{1,1},{1,-1},{-1,1},{-1,-1} };
+	const int32 RookDirections[4][2] = { {1,0},{-1,0},{0,1},{0,-1} };
+	const int32 BishopDirections[4][2] = { {1,1},{1,-1},{-1,1},{-1,-1} };
+
+	void AddPawnMove(FChessMoveList& OutMoves, int32 From, int32 To, uint8 Flags)
+	{
+		const int32 ToRow = ChessSquare::Row(To);
+		if (ToRow == 0 || ToRow == 7)
+		{
+			Flags |= EChessMoveFlags::Promotion;
+			OutMoves.Emplace(From, To, Flags, EChessPieceType::Queen);
+			OutMoves.Emplace(From, To, Flags, EChessPieceType::Knight);
+			OutMoves.Emplace(From, To, Flags, EChessPieceType::Rook);
+			OutMoves.Emplace(From, To, Flags, EChessPieceType::Bishop);
+		}
+		else
+		{
+			OutMoves.Emplace(From, To, Flags);
+		}
+	}
+
+	void GeneratePawnMoves(const FChessPosition& Position, int32 From, FChessMoveList& OutMoves, bool bCapturesOnly)
+	{
+		const EChessColor Us = Position.GetSideToMove();
+		const int32 Row = ChessSquare::Row(From);
+		const int32 Col = ChessSquare::Col(From);
+		const int32 Dir = (Us == EChessColor::White) ? 1 : -1;
+		const int32 StartRow = (Us == EChessColor::White) ? 1 : 6;
+		const int32 PromotionRow = (Us == EChessColor::White) ? 7 : 0;
+
+		// Promotions are generated with captures so quiescence sees them.
+		if (!bCapturesOnly || Row + Dir == PromotionRow)
+		{
+			if (Position.GetPieceAt(Row + Dir, Col).IsEmpty())
+			{
+				AddPawnMove(OutMoves, From, ChessSquare::Make(Row + Dir, Col), EChessMoveFlags::None);
+				if (!bCapturesOnly && Row == StartRow && Position.GetPieceAt(Row + 2 * Dir, Col).IsEmpty())
+					OutMoves.Emplace(From, ChessSquare::Make(Row + 2 * Dir, Col), EChessMoveFlags::DoublePush);
+			}
+		}
+
+		for (int32 dc = -1; dc <= 1; dc += 2)
+		{
+			if (!ChessSquare::IsOnBoard(Row + Dir, Col + dc))
+				continue;
+
+			const int32 To = ChessSquare::Make(Row + Dir, Col + dc);
+			const FChessPiece& Target = Position.GetPiece(To);
+			if (!Target.IsEmpty() && Target.Color != Us)
+				AddPawnMove(OutMoves, From, To, EChessMoveFlags::Capture);
+			else if (To == Position.GetEnPassantSquare())
+				OutMoves.Emplace(From, To, EChessMoveFlags::EnPassant);
+		}
+	}
+
+	void GenerateStepMoves(const FChessPosition& Position, int32 From, const int32 (&Offsets)[8][2], FChessMoveList& OutMoves, bool bCapturesOnly)
+	{
+		const EChessColor Us = Position.GetSideToMove();
+		const int32 Row = ChessSquare::Row(From);
+		const int32 Col = ChessSquare::Col(From);
+
+		for (const auto& Offset : Offsets)
+		{
+			const int32 R = Row + Offset[0], C = Col + Offset[1];
+			if (!ChessSquare::IsOnBoard(R, C))
+				continue;
+
+			const FChessPiece& Target = Position.GetPieceAt(R, C);
+			if (Target.IsEmpty())
+			{
+				if (!bCapturesOnly)
+					OutMoves.Emplace(From, ChessSquare::Make(R, C));
+			}
+			else if (Target.Color != Us)
+			{
+				OutMoves.Emplace(From, ChessSquare::Make(R, C), EChessMoveFlags::Capture);
+			}
+		}
+	}
+
+	void GenerateSliderMoves(const FChessPosition& Position, int32 From, const int32 (&Directions)[4][2], FChessMoveList& OutMoves, bool bCapturesOnly)
+	{
+		const EChessColor Us = Position.GetSideToMove();
+		const int32 Row = ChessSquare::Row(From);
+		const int32 Col = ChessSquare::Col(From);
+
+		for (const auto& D : Directions)
+		{
+			for (int32 R = Row + D[0], C = Col + D[1]; ChessSquare::IsOnBoard(R, C); R += D[0], C += D[1])
+			{
+				const FChessPiece& Target = Position.GetPieceAt(R, C);
+				if (Target.IsEmpty())
+				{
+					if (!bCapturesOnly)
+						OutMoves.Emplace(From, ChessSquare::Make(R, C));
+					continue;
+				}
+				if (Target.Color != Us)
+					OutMoves.Emplace(From, ChessSquare::Make(R, C), EChessMoveFlags::Capture);
+				break;
+			}
+		}
+	}
+
+	void GenerateCastling(const FChessPosition& Position, int32 From, FChessMoveList& OutMoves)
+	{
+		const EChessColor Us = Position.GetSideToMove();
+		const EChessColor Them = GetOpponent(Us);
+		const int32 Row = (Us == EChessColor::White) ? 0 : 7;
+		if (From != ChessSquare::Make(Row, 4))
+			return;
+
+		const uint8 Rights = Position.GetCastlingRights();
+		const uint8 KingSide = (Us == EChessColor::White) ? EChessCastling::WhiteKing : EChessCastling::BlackKing;
+		const uint8 QueenSide = (Us == EChessColor::White) ? EChessCastling::WhiteQueen : EChessCastling::BlackQueen;
+
+		if ((Rights & (KingSide | QueenSide)) == 0 || Position.IsSquareAttacked(From, Them))
+			return;
+
+		if ((Rights & KingSide)
+			&& Position.GetPieceAt(Row, 5).IsEmpty() && Position.GetPieceAt(Row, 6).IsEmpty()
+			&& !Position.IsSquareAttacked(ChessSquare::Make(Row, 5), Them))
+		{
+			// The destination square is checked by the usual legality test after the move.
+			OutMoves.Emplace(From, ChessSquare::Make(Row, 6), EChessMoveFlags::CastleKing);
+		}
+
+		if ((Rights & QueenSide)
+			&& Position.GetPieceAt(Row, 3).IsEmpty() && Position.GetPieceAt(Row, 2).IsEmpty() && Position.GetPieceAt(Row, 1).IsEmpty()
+			&& !Position.IsSquareAttacked(ChessSquare::Make(Row, 3), Them))
+		{
+			OutMoves.Emplace(From, ChessSquare::Make(Row, 2), EChessMoveFlags::CastleQueen);
+		}
+	}
+
+	void GenerateFrom(const FChessPosition& Position, int32 From, FChessMoveList& OutMoves, bool bCapturesOnly)
+	{
+		const FChessPiece& Piece = Position.GetPiece(From);
+		if (Piece.IsEmpty() || Piece.Color != Position.GetSideToMove())
+			return;
+
+		switch (Piece.Type)
+		{
+		case EChessPieceType::Pawn:
+			GeneratePawnMoves(Position, From, OutMoves, bCapturesOnly);
+			break;
+		case EChessPieceType::Knight:
+			GenerateStepMoves(Position, From, KnightOffsets, OutMoves, bCapturesOnly);
+			break;
+		case EChessPieceType::Bishop:
+			GenerateSliderMoves(Position, From, BishopDirections, OutMoves, bCapturesOnly);
+			break;
+		case EChessPieceType::Rook:
+			GenerateSliderMoves(Position, From, RookDirections, OutMoves, bCapturesOnly);
+			break;
+		case EChessPieceType::Queen:
+			GenerateSliderMoves(Position, From, RookDirections, OutMoves, bCapturesOnly);
+			GenerateSliderMoves(Position, From, BishopDirections, OutMoves, bCapturesOnly);
+			break;
+		case EChessPieceType::King:
+			GenerateStepMoves(Position, From, KingOffsets, OutMoves, bCapturesOnly);
+			if (!bCapturesOnly)
+				GenerateCastling(Position, From, OutMoves);
+			break;
+		default:
+			break;
+		}
+	}
+
+	void FilterLegal(const FChessPosition& Position, FChessMoveList& InOutMoves, int32 FirstIndex)
+	{
+		FChessPosition Scratch = Position;
+		const EChessColor Us = Position.GetSideToMove();
+
+		int32 Write = FirstIndex;
+		for (int32 Read = FirstIndex; Read < InOutMoves.Num(); ++Read)
+		{
+			FChessPosition::FUndo Undo;
+			Scratch.MakeMove(InOutMoves[Read], Undo);
+			const bool bLegal = !Scratch.IsInCheck(Us);
+			Scratch.UnmakeMove(InOutMoves[Read], Undo);
+
+			if (bLegal)
+				InOutMoves[Write++] = InOutMoves[Read];
+		}
+		InOutMoves.SetNum(Write, EAllowShrinking::No);
+	}
+}
+
+void FChessMoveGenerator::GeneratePseudoLegal(const FChessPosition& Position, FChessMoveList& OutMoves, bool bCapturesOnly)
+{
+	for (int32 Square = 0; Square < 64; ++Square)
+		GenerateFrom(Position, Square, OutMoves, bCapturesOnly);
+}
+
+void FChessMoveGenerator::GenerateLegal(const FChessPosition& Position, FChessMoveList& OutMoves)
+{
+	const int32 FirstIndex = OutMoves.Num();
+	GeneratePseudoLegal(Position, OutMoves);
+	FilterLegal(Position, OutMoves, FirstIndex);
+}
+
+void FChessMoveGenerator::GenerateLegalFrom(const FChessPosition& Position, int32 Square, FChessMoveList& OutMoves)
+{
+	const int32 FirstIndex = OutMoves.Num();
+	GenerateFrom(Position, Square, OutMoves, false);
+	FilterLegal(Position, OutMoves, FirstIndex);
+}
+
+FChessMove FChessMoveGenerator::ParseUciMove(const FChessPosition& Position, const FString& Text)
+{
+	if (Text.Len() < 4)
+		return FChessMove();
+
+	const int32 From = ChessSquare::FromString(Text.Left(2));
+	const int32 To = ChessSquare::FromString(Text.Mid(2, 2));
+	if (From == ChessSquare::None || To == ChessSquare::None)
+		return FChessMove();
+
+	EChessPieceType Promotion = EChessPieceType::None;
+	if (Text.Len() > 4)
+	{
+		switch (FChar::ToLower(Text[4]))
+		{
+		case TEXT('q'): Promotion = EChessPieceType::Queen; break;
+		case TEXT('r'): Promotion = EChessPieceType::Rook; break;
+		case TEXT('b'): Promotion = EChessPieceType::Bishop; break;
+		case TEXT('n'): Promotion = EChessPieceType::Knight; break;
+		default: break;
+		}
+	}
+
+	FChessMoveList Moves;
+	GenerateLegalFrom(Position, From, Moves);
+	for (const FChessMove& Move : Moves)
+		if (Move.To == To && Move.Promotion == Promotion)
+			return Move;
+
+	return FChessMove();
+}
+
+uint64 FChessMoveGenerator::Perft(FChessPosition& Position, int32 Depth)
+{
+	if (Depth <= 0)
+		return 1;
+
+	FChessMoveList Moves;
+	GeneratePseudoLegal(Position, Moves);
+
+	const EChessColor Us = Position.GetSideToMove();
+	uint64 Nodes = 0;
+	for (const FChessMove& Move : Moves)
+	{
+		FChessPosition::FUndo Undo;
+		Position.MakeMove(Move, Undo);
+		if (!Position.IsInCheck(Us))
+			Nodes += Perft(Position, Depth - 1);
+		Position.UnmakeMove(Move, Undo);
+	}
+	return Nodes;
+}
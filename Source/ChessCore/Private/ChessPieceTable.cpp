@@ -0,0 +1,285 @@
+#include "ChessPieceTable.h"
+
+FChessPieceTable::FChessPieceTable()
+{
+	Reset();
+}
+
+void FChessPieceTable::Reset()
+{
+	Count = 0;
+	UndoStack.Reset();
+	FMemory::Memset(Squares, ChessSquare::None, sizeof(Squares));
+	FMemory::Memset(SquareToId, NoPiece, sizeof(SquareToId));
+	for (int32 Id = 0; Id < MaxPieces; ++Id)
+	{
+		Types[Id] = EChessPieceType::None;
+		Colors[Id] = EChessColor::White;
+		Flags[Id] = EChessPieceFlags::None;
+	}
+}
+
+void FChessPieceTable::SetFromPosition(const FChessPosition& Position)
+{
+	Reset();
+
+	const uint8 Castling = Position.GetCastlingRights();
+	for (int32 Square = 0; Square < 64; ++Square)
+	{
+		const FChessPiece& Piece = Position.GetPiece(Square);
+		if (Piece.IsEmpty())
+			continue;
+		if (!ensureMsgf(Count < MaxPieces, TEXT("More than %d pieces on the board"), MaxPieces))
+			break;
+
+		const int32 Id = Count++;
+		Squares[Id] = (int8)Square;
+		Types[Id] = Piece.Type;
+		Colors[Id] = Piece.Color;
+		SquareToId[Square] = (int8)Id;
+
+		const bool bWhite = Piece.Color == EChessColor::White;
+		const int32 Row = ChessSquare::Row(Square);
+		const int32 BackRank = bWhite ? 0 : 7;
+		const uint8 KingSide = bWhite ? EChessCastling::WhiteKing : EChessCastling::BlackKing;
+		const uint8 QueenSide = bWhite ? EChessCastling::WhiteQueen : EChessCastling::BlackQueen;
+
+		bool bMoved = false;
+		switch (Piece.Type)
+		{
+		case EChessPieceType::Pawn:
+			bMoved = Row != (bWhite ? 1 : 6);
+			break;
+		case EChessPieceType::King:
+			bMoved = (Castling & (KingSide | QueenSide)) == 0;
+			break;
+		case EChessPieceType::Rook:
+			bMoved = !((Square == ChessSquare::Make(BackRank, 7) && (Castling & KingSide))
+				|| (Square == ChessSquare::Make(BackRank, 0) && (Castling & QueenSide)));
+			break;
+		default:
+			break;
+		}
+		if (bMoved)
+			Flags[Id] |= EChessPieceFlags::HasMoved;
+	}
+
+	// The pawn that can be taken en passant is the one that just double-moved.
+	const int32 EnPassant = Position.GetEnPassantSquare();
+	if (ChessSquare::IsValid(EnPassant))
+	{
+		const int32 PawnSquare = EnPassant + (Position.GetSideToMove() == EChessColor::White ? -8 : 8);
+		const int8 PawnId = GetIdAt(PawnSquare);
+		if (PawnId != NoPiece)
+			Flags[PawnId] |= EChessPieceFlags::JustDoubleMoved;
+	}
+}
+
+FChessPieceTable::FMoveEffects FChessPieceTable::ApplyMove(const FChessMove& Move)
+{
+	FMoveEffects Effects;
+	Effects.MovedId = GetIdAt(Move.From);
+	if (!ensure(Effects.MovedId != NoPiece))
+		return Effects;
+
+	FUndoRecord& Undo = UndoStack.AddDefaulted_GetRef();
+	Undo.Move = Move;
+	Undo.MovedFlags = Flags[Effects.MovedId];
+
+	for (int32 Id = 0; Id < Count; ++Id)
+	{
+		if (Flags[Id] & EChessPieceFlags::JustDoubleMoved)
+			Undo.DoubleMovedId = (int8)Id;
+		Flags[Id] &= ~EChessPieceFlags::JustDoubleMoved;
+	}
+
+	// En passant takes the pawn beside the mover, not one on the target square.
+	Effects.CapturedId = GetIdAt(GetCaptureSquare(Move));
+	if (Effects.CapturedId != NoPiece)
+	{
+		Undo.CapturedFlags = Flags[Effects.CapturedId];
+		CapturePiece(Effects.CapturedId);
+	}
+
+	if (Move.IsCastle())
+	{
+		Effects.RookId = GetIdAt(GetRookSquares(Move).Key);
+		if (ensure(Effects.RookId != NoPiece))
+		{
+			Undo.RookFlags = Flags[Effects.RookId];
+			MovePiece(Effects.RookId, GetRookSquares(Move).Value);
+			Flags[Effects.RookId] |= EChessPieceFlags::HasMoved;
+		}
+	}
+
+	MovePiece(Effects.MovedId, Move.To);
+	Flags[Effects.MovedId] |= EChessPieceFlags::HasMoved;
+	if (Move.Flags & EChessMoveFlags::DoublePush)
+		Flags[Effects.MovedId] |= EChessPieceFlags::JustDoubleMoved;
+
+	if (Move.IsPromotion())
+	{
+		Types[Effects.MovedId] = Move.Promotion;
+		Effects.bPromoted = true;
+	}
+
+	Undo.Effects = Effects;
+	return Effects;
+}
+
+FChessPieceTable::FMoveEffects FChessPieceTable::UndoMove()
+{
+	if (UndoStack.Num() == 0)
+		return FMoveEffects();
+
+	const FUndoRecord Undo = UndoStack.Pop(EAllowShrinking::No);
+	const FChessMove& Move = Undo.Move;
+	const FMoveEffects& Effects = Undo.Effects;
+
+	// The mover leaves the target square first, so a captured piece can be put back on it.
+	MovePiece(Effects.MovedId, Move.From);
+	Flags[Effects.MovedId] = Undo.MovedFlags;
+	if (Effects.bPromoted)
+		Types[Effects.MovedId] = EChessPieceType::Pawn;
+
+	if (Effects.RookId != NoPiece)
+	{
+		MovePiece(Effects.RookId, GetRookSquares(Move).Key);
+		Flags[Effects.RookId] = Undo.RookFlags;
+	}
+
+	if (Effects.CapturedId != NoPiece)
+	{
+		MovePiece(Effects.CapturedId, GetCaptureSquare(Move));
+		Flags[Effects.CapturedId] = Undo.CapturedFlags;
+	}
+
+	if (Undo.DoubleMovedId != NoPiece)
+		Flags[Undo.DoubleMovedId] |= EChessPieceFlags::JustDoubleMoved;
+
+	return Effects;
+}
+
+int32 FChessPieceTable::GetCaptureSquare(const FChessMove& Move)
+{
+	return (Move.Flags & EChessMoveFlags::EnPassant)
+		? ChessSquare::Make(ChessSquare::Row(Move.From), ChessSquare::Col(Move.To))
+		: Move.To;
+}
+
+TPair<int32, int32> FChessPieceTable::GetRookSquares(const FChessMove& Move)
+{
+	const int32 Row = ChessSquare::Row(Move.From);
+	const bool bKingSide = (Move.Flags & EChessMoveFlags::CastleKing) != 0;
+	return TPair<int32, int32>(ChessSquare::Make(Row, bKingSide ? 7 : 0), ChessSquare::Make(Row, bKingSide ? 5 : 3));
+}
+
+void FChessPieceTable::MovePiece(int32 Id, int32 To)
+{
+	// Captured pieces have no square to vacate.
+	if (ChessSquare::IsValid(Squares[Id]) && SquareToId[Squares[Id]] == Id)
+		SquareToId[Squares[Id]] = NoPiece;
+	Squares[Id] = (int8)To;
+	SquareToId[To] = (int8)Id;
+}
+
+void FChessPieceTable::CapturePiece(int32 Id)
+{
+	SquareToId[Squares[Id]] = NoPiece;
+	Squares[Id] = ChessSquare::None;
+	Flags[Id] = (uint8)((Flags[Id] | EChessPieceFlags::Captured) & ~EChessPieceFlags::JustDoubleMoved);
+}
+
+bool FChessPieceTable::IsInSyncWith(const FChessPosition& Position) const
+{
+	for (int32 Square = 0; Square < 64; ++Square)
+	{
+		const FChessPiece& Piece = Position.GetPiece(Square);
+		const int8 Id = SquareToId[Square];
+		if (Piece.IsEmpty() != (Id == NoPiece))
+			return false;
+		if (Id != NoPiece && (Squares[Id] != Square || Types[Id] != Piece.Type || Colors[Id] != Piece.Color || IsCaptured(Id)))
+			return false;
+	}
+	return true;
+}
+
+FArchive& operator<<(FArchive& Ar, FChessPieceTable& Table)
+{
+	// Archives may come from disk or the network, so anything that does not describe a real table is refused.
+	auto Fail = [&Ar, &Table]() -> FArchive&
+	{
+		Ar.SetError();
+		Table.Reset();
+		return Ar;
+	};
+
+	Ar << Table.Count;
+	if (Ar.IsLoading() && (Table.Count < 0 || Table.Count > FChessPieceTable::MaxPieces))
+		return Fail();
+
+	for (int32 Id = 0; Id < Table.Count; ++Id)
+	{
+		Ar << Table.Squares[Id];
+		Ar << Table.Types[Id];
+		Ar << Table.Colors[Id];
+		Ar << Table.Flags[Id];
+	}
+
+	// The square map is derived, so it is rebuilt rather than stored. Every live piece needs a
+	// square of its own and every captured one none.
+	if (Ar.IsLoading())
+	{
+		constexpr uint8 KnownFlags = EChessPieceFlags::HasMoved | EChessPieceFlags::JustDoubleMoved | EChessPieceFlags::Captured;
+
+		FMemory::Memset(Table.SquareToId, FChessPieceTable::NoPiece, sizeof(Table.SquareToId));
+		for (int32 Id = 0; Id < Table.Count; ++Id)
+		{
+			const int8 Square = Table.Squares[Id];
+			const bool bCaptured = Table.IsCaptured(Id);
+			if ((uint8)Table.Types[Id] >= (uint8)EChessPieceType::None
+				|| (uint8)Table.Colors[Id] > (uint8)EChessColor::Black
+				|| (Table.Flags[Id] & ~KnownFlags) != 0
+				|| (bCaptured ? Square != ChessSquare::None : !ChessSquare::IsValid(Square) || Table.SquareToId[Square] != FChessPieceTable::NoPiece))
+				return Fail();
+
+			if (!bCaptured)
+				Table.SquareToId[Square] = (int8)Id;
+		}
+	}
+
+	// Takeback history, so a loaded game can still be undone move by move.
+	int32 NumUndo = Table.UndoStack.Num();
+	Ar << NumUndo;
+	if (Ar.IsLoading())
+	{
+		// Each record takes several bytes, so refuse a count the archive cannot hold before allocating for it.
+		const int64 BytesLeft = Ar.TotalSize() >= 0 ? Ar.TotalSize() - Ar.Tell() : MAX_int64;
+		if (NumUndo < 0 || NumUndo > FChessPieceTable::MaxUndoRecords || NumUndo > BytesLeft)
+			return Fail();
+		Table.UndoStack.SetNum(NumUndo);
+	}
+
+	auto IsValidRecordId = [&Table](int8 Id) { return Id == FChessPieceTable::NoPiece || Table.IsValidId(Id); };
+	auto IsValidPromotion = [](EChessPieceType Type)
+	{
+		return Type == EChessPieceType::None || Type == EChessPieceType::Rook || Type == EChessPieceType::Knight
+			|| Type == EChessPieceType::Bishop || Type == EChessPieceType::Queen;
+	};
+	for (FChessPieceTable::FUndoRecord& Undo : Table.UndoStack)
+	{
+		Ar << Undo.Move.From << Undo.Move.To << Undo.Move.Promotion << Undo.Move.Flags;
+		Ar << Undo.Effects.MovedId << Undo.Effects.CapturedId << Undo.Effects.RookId << Undo.Effects.bPromoted;
+		Ar << Undo.MovedFlags << Undo.CapturedFlags << Undo.RookFlags << Undo.DoubleMovedId;
+
+		if (Ar.IsLoading() && (!ChessSquare::IsValid(Undo.Move.From) || !ChessSquare::IsValid(Undo.Move.To)
+			|| !IsValidPromotion(Undo.Move.Promotion) || !Table.IsValidId(Undo.Effects.MovedId)
+			|| !IsValidRecordId(Undo.Effects.CapturedId) || !IsValidRecordId(Undo.Effects.RookId)
+			|| !IsValidRecordId(Undo.DoubleMovedId)))
+			return Fail();
+	}
+
+	if (Ar.IsLoading() && Ar.IsError())
+		return Fail();
+	return Ar;
+}
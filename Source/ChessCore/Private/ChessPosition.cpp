@@ -0,0 +1,478 @@
+#include "ChessPosition.h"
+
+const TCHAR* FChessPosition::StartFen = TEXT("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+
+namespace
+{
+	struct FZobristKeys
+	{
+		uint64 Pieces[2][6][64];
+		uint64 Castling[16];
+		uint64 EnPassantFile[8];
+		uint64 SideToMove;
+
+		FZobristKeys()
+		{
+			// Fixed seed so hashes are stable across runs and processes.
+			uint64 State = 0x9E3779B97F4A7C15ull;
+			auto Next = [&State]()
+				{
+					uint64 Z = (State += 0x9E3779B97F4A7C15ull);
+					Z = (Z ^ (Z >> 30)) * 0xBF58476D1CE4E5B9ull;
+					Z = (Z ^ (Z >> 27)) * 0x94D049BB133111EBull;
+					return Z ^ (Z >> 31);
+				};
+
+			for (auto& Color : Pieces)
+				for (auto& Type : Color)
+					for (uint64& Key : Type)
+						Key = Next();
+			for (uint64& Key : Castling)
+				Key = Next();
+			for (uint64& Key : EnPassantFile)
+				Key = Next();
+			SideToMove = Next();
+		}
+	};
+
+	const FZobristKeys Zobrist;
+
+	FORCEINLINE uint64 PieceKey(const FChessPiece& Piece, int32 Square)
+	{
+		return Zobrist.Pieces[(uint8)Piece.Color][(uint8)Piece.Type][Square];
+	}
+
+	// Rights that survive a move touching the given square.
+	uint8 CastlingMask(int32 Square)
+	{
+		switch (Square)
+		{
+		case 0:  return (uint8)~EChessCastling::WhiteQueen;
+		case 4:  return (uint8)~(EChessCastling::WhiteKing | EChessCastling::WhiteQueen);
+		case 7:  return (uint8)~EChessCastling::WhiteKing;
+		case 56: return (uint8)~EChessCastling::BlackQueen;
+		case 60: return (uint8)~(EChessCastling::BlackKing | EChessCastling::BlackQueen);
+		case 63: return (uint8)~EChessCastling::BlackKing;
+		default: return EChessCastling::All;
+		}
+	}
+
+	const int32 KnightOffsets[8][2] = { {2,1},{1,2},{-1,2},{-2,1},{-2,-1},{-1,-2},{1,-2},{2,-1} };
+	const int32 KingOffsets[8][2] = { {1,0},{-1,0},{0,1},{0,-1},{1,1},{1,-1},{-1,1},{-1,-1} };
+	const int32 RookDirections[4][2] = { {1,0},{-1,0},{0,1},{0,-1} };
+	const int32 BishopDirections[4][2] = { {1,1},{1,-1},{-1,1},{-1,-1} };
+
+	TCHAR PieceToChar(const FChessPiece& Piece)
+	{
+		static const TCHAR Chars[] = TEXT("prnbqk");
+		const TCHAR Ch = Chars[(uint8)Piece.Type];
+		return Piece.Color == EChessColor::White ? FChar::ToUpper(Ch) : Ch;
+	}
+
+	bool CharToPiece(TCHAR Ch, FChessPiece& OutPiece)
+	{
+		const EChessColor Color = FChar::IsUpper(Ch) ? EChessColor::White : EChessColor::Black;
+		switch (FChar::ToLower(Ch))
+		{
+		case TEXT('p'): OutPiece = FChessPiece(EChessPieceType::Pawn, Color); return true;
+		case TEXT('r'): OutPiece = FChessPiece(EChessPieceType::Rook, Color); return true;
+		case TEXT('n'): OutPiece = FChessPiece(EChessPieceType::Knight, Color); return true;
+		case TEXT('b'): OutPiece = FChessPiece(EChessPieceType::Bishop, Color); return true;
+		case TEXT('q'): OutPiece = FChessPiece(EChessPieceType::Queen, Color); return true;
+		case TEXT('k'): OutPiece = FChessPiece(EChessPieceType::King, Color); return true;
+		default: return false;
+		}
+	}
+}
+
+FChessPosition::FChessPosition()
+{
+	Clear();
+	SetStartPosition();
+}
+
+void FChessPosition::Clear()
+{
+	for (FChessPiece& Piece : Board)
+		Piece = FChessPiece();
+
+	KingSquare[0] = KingSquare[1] = ChessSquare::None;
+	SideToMove = EChessColor::White;
+	CastlingRights = EChessCastling::None;
+	EnPassantSquare = ChessSquare::None;
+	HalfmoveClock = 0;
+	FullmoveNumber = 1;
+	Hash = ComputeHash();
+}
+
+void FChessPosition::SetStartPosition()
+{
+	verify(SetFromFen(StartFen));
+}
+
+bool FChessPosition::SetFromFen(const FString& Fen)
+{
+	TArray<FString> Fields;
+	Fen.ParseIntoArrayWS(Fields);
+	if (Fields.Num() < 4)
+		return false;
+
+	FChessPosition Parsed(*this);
+	Parsed.Clear();
+
+	int32 Row = 7;
+	int32 Col = 0;
+	for (int32 i = 0; i < Fields[0].Len(); ++i)
+	{
+		const TCHAR Ch = Fields[0][i];
+		FChessPiece Piece;
+		if (Ch == TEXT('/'))
+		{
+			--Row;
+			Col = 0;
+		}
+		else if (FChar::IsDigit(Ch))
+		{
+			Col += Ch - TEXT('0');
+		}
+		else if (CharToPiece(Ch, Piece) && ChessSquare::IsOnBoard(Row, Col))
+		{
+			// Move generation assumes a pawn always has a square ahead of it.
+			if (Piece.Type == EChessPieceType::Pawn && (Row == 0 || Row == 7))
+				return false;
+
+			Parsed.PlacePiece(ChessSquare::Make(Row, Col), Piece);
+			++Col;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	if (Parsed.KingSquare[0] == ChessSquare::None || Parsed.KingSquare[1] == ChessSquare::None)
+		return false;
+
+	Parsed.SideToMove = Fields[1] == TEXT("b") ? EChessColor::Black : EChessColor::White;
+
+	for (int32 i = 0; i < Fields[2].Len(); ++i)
+	{
+		switch (Fields[2][i])
+		{
+		case TEXT('K'): Parsed.CastlingRights |= EChessCastling::WhiteKing; break;
+		case TEXT('Q'): Parsed.CastlingRights |= EChessCastling::WhiteQueen; break;
+		case TEXT('k'): Parsed.CastlingRights |= EChessCastling::BlackKing; break;
+		case TEXT('q'): Parsed.CastlingRights |= EChessCastling::BlackQueen; break;
+		default: break;
+		}
+	}
+
+	// Castling moves the king and rook without looking, so every right needs both on their home squares.
+	struct FCastlingHome { EChessCastling::Type Right; EChessColor Color; int32 RookCol; };
+	const FCastlingHome CastlingHomes[] =
+	{
+		{ EChessCastling::WhiteKing,  EChessColor::White, 7 },
+		{ EChessCastling::WhiteQueen, EChessColor::White, 0 },
+		{ EChessCastling::BlackKing,  EChessColor::Black, 7 },
+		{ EChessCastling::BlackQueen, EChessColor::Black, 0 },
+	};
+	for (const FCastlingHome& Home : CastlingHomes)
+	{
+		if (!(Parsed.CastlingRights & Home.Right))
+			continue;
+
+		const int32 HomeRow = Home.Color == EChessColor::White ? 0 : 7;
+		if (!Parsed.GetPieceAt(HomeRow, 4).Is(EChessPieceType::King, Home.Color)
+			|| !Parsed.GetPieceAt(HomeRow, Home.RookCol).Is(EChessPieceType::Rook, Home.Color))
+			return false;
+	}
+
+	if (Fields[3] != TEXT("-"))
+	{
+		// En passant removes the pawn beside the target without looking, so the square must be one an
+		// enemy pawn has just skipped over: on the third rank from its side, empty, with its start
+		// square empty too and the pawn standing right in front.
+		const int32 Square = ChessSquare::FromString(Fields[3]);
+		if (Square == ChessSquare::None)
+			return false;
+
+		const bool bWhiteToMove = Parsed.SideToMove == EChessColor::White;
+		const int32 Row = ChessSquare::Row(Square);
+		const int32 Col = ChessSquare::Col(Square);
+		if (Row != (bWhiteToMove ? 5 : 2)
+			|| !Parsed.GetPieceAt(Row, Col).IsEmpty()
+			|| !Parsed.GetPieceAt(bWhiteToMove ? Row + 1 : Row - 1, Col).IsEmpty()
+			|| !Parsed.GetPieceAt(bWhiteToMove ? Row - 1 : Row + 1, Col).Is(EChessPieceType::Pawn, GetOpponent(Parsed.SideToMove)))
+			return false;
+
+		Parsed.SetEnPassantSquare(Square);
+	}
+
+	Parsed.HalfmoveClock = Fields.Num() > 4 ? FCString::Atoi(*Fields[4]) : 0;
+	Parsed.FullmoveNumber = Fields.Num() > 5 ? FMath::Max(1, FCString::Atoi(*Fields[5])) : 1;
+	Parsed.Hash = Parsed.ComputeHash();
+
+	*this = Parsed;
+	return true;
+}
+
+FString FChessPosition::ToFen() const
+{
+	FString Fen;
+	for (int32 Row = 7; Row >= 0; --Row)
+	{
+		int32 Empty = 0;
+		for (int32 Col = 0; Col < 8; ++Col)
+		{
+			const FChessPiece& Piece = GetPieceAt(Row, Col);
+			if (Piece.IsEmpty())
+			{
+				++Empty;
+				continue;
+			}
+			if (Empty > 0)
+			{
+				Fen.AppendInt(Empty);
+				Empty = 0;
+			}
+			Fen.AppendChar(PieceToChar(Piece));
+		}
+		if (Empty > 0)
+			Fen.AppendInt(Empty);
+		if (Row > 0)
+			Fen.AppendChar(TEXT('/'));
+	}
+
+	Fen += SideToMove == EChessColor::White ? TEXT(" w ") : TEXT(" b ");
+
+	if (CastlingRights == EChessCastling::None)
+		Fen.AppendChar(TEXT('-'));
+	if (CastlingRights & EChessCastling::WhiteKing) Fen.AppendChar(TEXT('K'));
+	if (CastlingRights & EChessCastling::WhiteQueen) Fen.AppendChar(TEXT('Q'));
+	if (CastlingRights & EChessCastling::BlackKing) Fen.AppendChar(TEXT('k'));
+	if (CastlingRights & EChessCastling::BlackQueen) Fen.AppendChar(TEXT('q'));
+
+	Fen += FString::Printf(TEXT(" %s %d %d"), *ChessSquare::ToString(EnPassantSquare), HalfmoveClock, FullmoveNumber);
+	return Fen;
+}
+
+void FChessPosition::SetPiece(int32 Square, const FChessPiece& Piece)
+{
+	if (!Board[Square].IsEmpty())
+		RemovePiece(Square);
+	if (!Piece.IsEmpty())
+		PlacePiece(Square, Piece);
+}
+
+bool FChessPosition::IsSquareAttacked(int32 Square, EChessColor ByColor) const
+{
+	const int32 Row = ChessSquare::Row(Square);
+	const int32 Col = ChessSquare::Col(Square);
+
+	// A white pawn attacks upwards, so look one row down for it.
+	const int32 PawnRow = ByColor == EChessColor::White ? Row - 1 : Row + 1;
+	for (int32 dc = -1; dc <= 1; dc += 2)
+		if (ChessSquare::IsOnBoard(PawnRow, Col + dc) && GetPieceAt(PawnRow, Col + dc).Is(EChessPieceType::Pawn, ByColor))
+			return true;
+
+	for (const auto& Offset : KnightOffsets)
+	{
+		const int32 R = Row + Offset[0], C = Col + Offset[1];
+		if (ChessSquare::IsOnBoard(R, C) && GetPieceAt(R, C).Is(EChessPieceType::Knight, ByColor))
+			return true;
+	}
+
+	for (const auto& Offset : KingOffsets)
+	{
+		const int32 R = Row + Offset[0], C = Col + Offset[1];
+		if (ChessSquare::IsOnBoard(R, C) && GetPieceAt(R, C).Is(EChessPieceType::King, ByColor))
+			return true;
+	}
+
+	auto SliderAttacks = [&](const int32 (&Directions)[4][2], EChessPieceType Slider)
+		{
+			for (const auto& D : Directions)
+			{
+				for (int32 R = Row + D[0], C = Col + D[1]; ChessSquare::IsOnBoard(R, C); R += D[0], C += D[1])
+				{
+					const FChessPiece& Piece = GetPieceAt(R, C);
+					if (Piece.IsEmpty())
+						continue;
+					if (Piece.Color == ByColor && (Piece.Type == Slider || Piece.Type == EChessPieceType::Queen))
+						return true;
+					break;
+				}
+			}
+			return false;
+		};
+
+	return SliderAttacks(RookDirections, EChessPieceType::Rook) || SliderAttacks(BishopDirections, EChessPieceType::Bishop);
+}
+
+void FChessPosition::MakeMove(const FChessMove& Move, FUndo& OutUndo)
+{
+	const FChessPiece Moving = Board[Move.From];
+	const int32 FromRow = ChessSquare::Row(Move.From);
+
+	OutUndo.Captured = Board[Move.To];
+	OutUndo.CastlingRights = CastlingRights;
+	OutUndo.EnPassantSquare = (int8)EnPassantSquare;
+	OutUndo.HalfmoveClock = HalfmoveClock;
+	OutUndo.Hash = Hash;
+
+	++HalfmoveClock;
+
+	if (Move.Flags & EChessMoveFlags::EnPassant)
+	{
+		const int32 CapturedSquare = ChessSquare::Make(FromRow, ChessSquare::Col(Move.To));
+		OutUndo.Captured = Board[CapturedSquare];
+		RemovePiece(CapturedSquare);
+		HalfmoveClock = 0;
+	}
+	else if (!OutUndo.Captured.IsEmpty())
+	{
+		RemovePiece(Move.To);
+		HalfmoveClock = 0;
+	}
+
+	if (Moving.Type == EChessPieceType::Pawn)
+		HalfmoveClock = 0;
+
+	RemovePiece(Move.From);
+	PlacePiece(Move.To, Move.IsPromotion() ? FChessPiece(Move.Promotion, Moving.Color) : Moving);
+
+	if (Move.Flags & EChessMoveFlags::CastleKing)
+	{
+		const FChessPiece Rook = Board[ChessSquare::Make(FromRow, 7)];
+		RemovePiece(ChessSquare::Make(FromRow, 7));
+		PlacePiece(ChessSquare::Make(FromRow, 5), Rook);
+	}
+	else if (Move.Flags & EChessMoveFlags::CastleQueen)
+	{
+		const FChessPiece Rook = Board[ChessSquare::Make(FromRow, 0)];
+		RemovePiece(ChessSquare::Make(FromRow, 0));
+		PlacePiece(ChessSquare::Make(FromRow, 3), Rook);
+	}
+
+	Hash ^= Zobrist.Castling[CastlingRights];
+	CastlingRights &= CastlingMask(Move.From) & CastlingMask(Move.To);
+	Hash ^= Zobrist.Castling[CastlingRights];
+
+	if (SideToMove == EChessColor::Black)
+		++FullmoveNumber;
+	SideToMove = GetOpponent(SideToMove);
+	Hash ^= Zobrist.SideToMove;
+
+	SetEnPassantSquare((Move.Flags & EChessMoveFlags::DoublePush) ? (Move.From + Move.To) / 2 : ChessSquare::None);
+}
+
+void FChessPosition::UnmakeMove(const FChessMove& Move, const FUndo& Undo)
+{
+	SideToMove = GetOpponent(SideToMove);
+	if (SideToMove == EChessColor::Black)
+		--FullmoveNumber;
+
+	const int32 FromRow = ChessSquare::Row(Move.From);
+	if (Move.Flags & EChessMoveFlags::CastleKing)
+	{
+		const FChessPiece Rook = Board[ChessSquare::Make(FromRow, 5)];
+		RemovePiece(ChessSquare::Make(FromRow, 5));
+		PlacePiece(ChessSquare::Make(FromRow, 7), Rook);
+	}
+	else if (Move.Flags & EChessMoveFlags::CastleQueen)
+	{
+		const FChessPiece Rook = Board[ChessSquare::Make(FromRow, 3)];
+		RemovePiece(ChessSquare::Make(FromRow, 3));
+		PlacePiece(ChessSquare::Make(FromRow, 0), Rook);
+	}
+
+	const FChessPiece Moved = Board[Move.To];
+	RemovePiece(Move.To);
+	PlacePiece(Move.From, Move.IsPromotion() ? FChessPiece(EChessPieceType::Pawn, Moved.Color) : Moved);
+
+	if (Move.Flags & EChessMoveFlags::EnPassant)
+		PlacePiece(ChessSquare::Make(FromRow, ChessSquare::Col(Move.To)), Undo.Captured);
+	else if (!Undo.Captured.IsEmpty())
+		PlacePiece(Move.To, Undo.Captured);
+
+	CastlingRights = Undo.CastlingRights;
+	EnPassantSquare = Undo.EnPassantSquare;
+	HalfmoveClock = Undo.HalfmoveClock;
+	Hash = Undo.Hash;
+}
+
+void FChessPosition::MakeNullMove(FUndo& OutUndo)
+{
+	OutUndo.Captured = FChessPiece();
+	OutUndo.CastlingRights = CastlingRights;
+	OutUndo.EnPassantSquare = (int8)EnPassantSquare;
+	OutUndo.HalfmoveClock = HalfmoveClock;
+	OutUndo.Hash = Hash;
+
+	++HalfmoveClock;
+	SideToMove = GetOpponent(SideToMove);
+	Hash ^= Zobrist.SideToMove;
+	SetEnPassantSquare(ChessSquare::None);
+}
+
+void FChessPosition::UnmakeNullMove(const FUndo& Undo)
+{
+	SideToMove = GetOpponent(SideToMove);
+	EnPassantSquare = Undo.EnPassantSquare;
+	HalfmoveClock = Undo.HalfmoveClock;
+	Hash = Undo.Hash;
+}
+
+uint64 FChessPosition::ComputeHash() const
+{
+	uint64 Result = 0;
+	for (int32 Square = 0; Square < 64; ++Square)
+		if (!Board[Square].IsEmpty())
+			Result ^= PieceKey(Board[Square], Square);
+
+	Result ^= Zobrist.Castling[CastlingRights];
+	if (EnPassantSquare != ChessSquare::None)
+		Result ^= Zobrist.EnPassantFile[ChessSquare::Col(EnPassantSquare)];
+	if (SideToMove == EChessColor::Black)
+		Result ^= Zobrist.SideToMove;
+	return Result;
+}
+
+void FChessPosition::PlacePiece(int32 Square, const FChessPiece& Piece)
+{
+	Board[Square] = Piece;
+	Hash ^= PieceKey(Piece, Square);
+	if (Piece.Type == EChessPieceType::King)
+		KingSquare[(uint8)Piece.Color] = Square;
+}
+
+void FChessPosition::RemovePiece(int32 Square)
+{
+	Hash ^= PieceKey(Board[Square], Square);
+	Board[Square] = FChessPiece();
+}
+
+void FChessPosition::SetEnPassantSquare(int32 Square)
+{
+	if (EnPassantSquare != ChessSquare::None)
+		Hash ^= Zobrist.EnPassantFile[ChessSquare::Col(EnPassantSquare)];
+	EnPassantSquare = ChessSquare::None;
+
+	if (Square == ChessSquare::None)
+		return;
+
+	// Only record the square when the side to move could actually capture there, so
+	// otherwise identical positions hash the same for repetition and the table.
+	const int32 PawnRow = ChessSquare::Row(Square) + (SideToMove == EChessColor::White ? -1 : 1);
+	const int32 Col = ChessSquare::Col(Square);
+	bool bCapturable = false;
+	for (int32 dc = -1; dc <= 1; dc += 2)
+		if (ChessSquare::IsOnBoard(PawnRow, Col + dc) && GetPieceAt(PawnRow, Col + dc).Is(EChessPieceType::Pawn, SideToMove))
+			bCapturable = true;
+
+	if (bCapturable)
+	{
+		EnPassantSquare = Square;
+		Hash ^= Zobrist.EnPassantFile[Col];
+	}
+}
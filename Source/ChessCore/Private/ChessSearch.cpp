@@ -0,0 +1,741 @@
+#include "ChessSearch.h"
+#include "ChessMoveGenerator.h"
+#include "Async/Async.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Trace/Trace.inl"
+
+// Enable with -trace=cpu,ChessSearch (or "Trace.Enable ChessSearch") and inspect in Unreal Insights.
+UE_TRACE_CHANNEL_DEFINE(ChessSearchChannel)
+
+UE_TRACE_EVENT_BEGIN(ChessSearch, Progress)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint64, Nodes)
+	UE_TRACE_EVENT_FIELD(uint64, NodesPerSecond)
+	UE_TRACE_EVENT_FIELD(float, TTHitRate)
+	UE_TRACE_EVENT_FIELD(int32, Depth)
+	UE_TRACE_EVENT_FIELD(int32, SelDepth)
+	UE_TRACE_EVENT_FIELD(int32, Score)
+	UE_TRACE_EVENT_FIELD(bool, IterationComplete)
+UE_TRACE_EVENT_END()
+
+namespace
+{
+	// Indexed by EChessPieceType.
+	const int32 PieceValues[7] = { 100, 500, 320, 330, 900, 0, 0 };
+
+	// Piece-square tables from White's point of view, rank 8 first.
+	const int32 PawnTable[64] = {
+		 0,  0,  0,  0,  0,  0,  0,  0,
+		50, 50, 50, 50, 50, 50, 50, 50,
+		10, 10, 20, 30, 30, 20, 10, 10,
+		 5,  5, 10, 25, 25, 10,  5,  5,
+		 0,  0,  0, 20, 20,  0,  0,  0,
+		 5, -5,-10,  0,  0,-10, -5,  5,
+		 5, 10, 10,-20,-20, 10, 10,  5,
+		 0,  0,  0,  0,  0,  0,  0,  0 };
+
+	const int32 KnightTable[64] = {
+		-50,-40,-30,-30,-30,-30,-40,-50,
+		-40,-20,  0,  0,  0,  0,-20,-40,
+		-30,  0, 10, 15, 15, 10,  0,-30,
+		-30,  5, 15, 20, 20, 15,  5,-30,
+		-30,  0, 15, 20, 20, 15,  0,-30,
+		-30,  5, 10, 15, 15, 10,  5,-30,
+		-40,-20,  0,  5,  5,  0,-20,-40,
+		-50,-40,-30,-30,-30,-30,-40,-50 };
+
+	const int32 BishopTable[64] = {
+		-20,-10,-10,-10,-10,-10,-10,-20,
+		-10,  0,  0,  0,  0,  0,  0,-10,
+		-10,  0,  5, 10, 10,  5,  0,-10,
+		-10,  5,  5, 10, 10,  5,  5,-10,
+		-10,  0, 10, 10, 10, 10,  0,-10,
+		-10, 10, 10, 10, 10, 10, 10,-10,
+		-10,  5,  0,  0,  0,  0,  5,-10,
+		-20,-10,-10,-10,-10,-10,-10,-20 };
+
+	const int32 RookTable[64] = {
+		 0,  0,  0,  0,  0,  0,  0,  0,
+		 5, 10, 10, 10, 10, 10, 10,  5,
+		-5,  0,  0,  0,  0,  0,  0, -5,
+		-5,  0,  0,  0,  0,  0,  0, -5,
+		-5,  0,  0,  0,  0,  0,  0, -5,
+		-5,  0,  0,  0,  0,  0,  0, -5,
+		-5,  0,  0,  0,  0,  0,  0, -5,
+		 0,  0,  0,  5,  5,  0,  0,  0 };
+
+	const int32 QueenTable[64] = {
+		-20,-10,-10, -5, -5,-10,-10,-20,
+		-10,  0,  0,  0,  0,  0,  0,-10,
+		-10,  0,  5,  5,  5,  5,  0,-10,
+		 -5,  0,  5,  5,  5,  5,  0, -5,
+		  0,  0,  5,  5,  5,  5,  0, -5,
+		-10,  5,  5,  5,  5,  5,  0,-10,
+		-10,  0,  5,  0,  0,  0,  0,-10,
+		-20,-10,-10, -5, -5,-10,-10,-20 };
+
+	const int32 KingMiddlegameTable[64] = {
+		-30,-40,-40,-50,-50,-40,-40,-30,
+		-30,-40,-40,-50,-50,-40,-40,-30,
+		-30,-40,-40,-50,-50,-40,-40,-30,
+		-30,-40,-40,-50,-50,-40,-40,-30,
+		-20,-30,-30,-40,-40,-30,-30,-20,
+		-10,-20,-20,-20,-20,-20,-20,-10,
+		 20, 20,  0,  0,  0,  0, 20, 20,
+		 20, 30, 10,  0,  0, 10, 30, 20 };
+
+	const int32 KingEndgameTable[64] = {
+		-50,-40,-30,-20,-20,-30,-40,-50,
+		-30,-20,-10,  0,  0,-10,-20,-30,
+		-30,-10, 20, 30, 30, 20,-10,-30,
+		-30,-10, 30, 40, 40, 30,-10,-30,
+		-30,-10, 30, 40, 40, 30,-10,-30,
+		-30,-10, 20, 30, 30, 20,-10,-30,
+		-30,-30,  0,  0,  0,  0,-30,-30,
+		-50,-30,-30,-30,-30,-30,-30,-50 };
+
+	// Non-pawn material (both sides) at or below which the king should centralise.
+	const int32 EndgameMaterial = 1300;
+
+	const int32 TempoBonus = 10;
+
+	// Move ordering buckets.
+	const int32 HashMoveScore = 1 << 30;
+	const int32 CaptureScore = 1 << 26;
+	const int32 KillerScore = 1 << 25;
+
+	const uint32 StopCheckInterval = 2048;
+
+	// Mid-iteration progress events on the trace channel, so long iterations are not a flat line.
+	const uint64 TraceProgressInterval = 1 << 16;
+
+	FORCEINLINE int32 ScoreToTable(int32 Score, int32 Ply)
+	{
+		if (Score >= FChessSearch::MateThreshold) return Score + Ply;
+		if (Score <= -FChessSearch::MateThreshold) return Score - Ply;
+		return Score;
+	}
+
+	FORCEINLINE int32 ScoreFromTable(int32 Score, int32 Ply)
+	{
+		if (Score >= FChessSearch::MateThreshold) return Score - Ply;
+		if (Score <= -FChessSearch::MateThreshold) return Score + Ply;
+		return Score;
+	}
+}
+
+FChessTranspositionTable::FChessTranspositionTable()
+{
+	Resize(16);
+}
+
+void FChessTranspositionTable::Resize(int32 SizeMB)
+{
+	const uint64 Bytes = (uint64)FMath::Max(1, SizeMB) * 1024 * 1024;
+	EntryCount = FMath::Max<uint64>(1, Bytes / sizeof(FEntry));
+	Entries = MakeUnique<FEntry[]>(EntryCount);
+	Generation = 0;
+}
+
+void FChessTranspositionTable::Clear()
+{
+	for (uint64 i = 0; i < EntryCount; ++i)
+	{
+		Entries[i].KeyXorData.store(0, std::memory_order_relaxed);
+		Entries[i].Data.store(0, std::memory_order_relaxed);
+	}
+	Generation = 0;
+}
+
+bool FChessTranspositionTable::Probe(uint64 Key, FProbe& OutProbe) const
+{
+	const FEntry& Entry = Entries[Key % EntryCount];
+	const uint64 Data = Entry.Data.load(std::memory_order_relaxed);
+	if ((Entry.KeyXorData.load(std::memory_order_relaxed) ^ Data) != Key || Data == 0)
+		return false;
+
+	OutProbe.Move = FChessMove::Unpack((uint16)(Data & 0xFFFF));
+	OutProbe.Score = (int16)((Data >> 16) & 0xFFFF);
+	OutProbe.Depth = (int32)((Data >> 32) & 0xFF);
+	OutProbe.Bound = (EBound)((Data >> 40) & 0x3);
+	return true;
+}
+
+void FChessTranspositionTable::Store(uint64 Key, const FChessMove& Move, int32 Score, int32 Depth, EBound Bound)
+{
+	FEntry& Entry = Entries[Key % EntryCount];
+	const uint64 OldData = Entry.Data.load(std::memory_order_relaxed);
+	const uint64 OldKey = Entry.KeyXorData.load(std::memory_order_relaxed) ^ OldData;
+	const uint8 OldGeneration = (uint8)((OldData >> 42) & 0xFF);
+	const int32 OldDepth = (int32)((OldData >> 32) & 0xFF);
+
+	// Keep deeper results from this search for other positions; always refresh our own slot.
+	if (OldData != 0 && OldKey != Key && OldGeneration == Generation && OldDepth > Depth && Bound != EBound::Exact)
+		return;
+
+	// Keep the old best move if this store has none for the same position.
+	uint16 PackedMove = Move.Pack();
+	if (Move.IsNull() && OldKey == Key)
+		PackedMove = (uint16)(OldData & 0xFFFF);
+
+	const uint64 Data = (uint64)PackedMove
+		| ((uint64)(uint16)(int16)Score << 16)
+		| ((uint64)(uint8)FMath::Clamp(Depth, 0, 255) << 32)
+		| ((uint64)Bound << 40)
+		| ((uint64)Generation << 42);
+
+	Entry.KeyXorData.store(Key ^ Data, std::memory_order_relaxed);
+	Entry.Data.store(Data, std::memory_order_relaxed);
+}
+
+int32 FChessTranspositionTable::GetHashFullPermill() const
+{
+	const uint64 Samples = FMath::Min<uint64>(1000, EntryCount);
+	uint64 Used = 0;
+	for (uint64 i = 0; i < Samples; ++i)
+	{
+		const uint64 Data = Entries[i].Data.load(std::memory_order_relaxed);
+		if (Data != 0 && (uint8)((Data >> 42) & 0xFF) == Generation)
+			++Used;
+	}
+	return (int32)(Used * 1000 / FMath::Max<uint64>(1, Samples));
+}
+
+struct FChessSearch::FWorker
+{
+	FChessSearch& Owner;
+	const FChessSearchLimits& Limits;
+	const bool bMainThread;
+	const double StartTime;
+
+	FChessPosition Position;
+	TArray<uint64> HashStack;
+
+	FChessMove Killers[MaxPly][2];
+	int32 History[64][64];
+	FChessMove PV[MaxPly + 1][MaxPly + 1];
+	int32 PVLength[MaxPly + 1];
+
+	uint64 Nodes = 0;
+	uint64 TTProbes = 0;
+	uint64 TTHits = 0;
+	int32 SelDepth = 0;
+	int32 CurrentDepth = 0;
+
+	FChessSearchResult Result;
+
+	/** Root moves already claimed by better lines in this iteration (multi-PV). */
+	TArray<FChessMove, TInlineAllocator<8>> ExcludedRootMoves;
+
+	FWorker(FChessSearch& InOwner, const FChessPosition& Root, const TArray<uint64>& GameHistory, const FChessSearchLimits& InLimits, bool bInMainThread, double InStartTime)
+		: Owner(InOwner)
+		, Limits(InLimits)
+		, bMainThread(bInMainThread)
+		, StartTime(InStartTime)
+		, Position(Root)
+		, HashStack(GameHistory)
+	{
+		FMemory::Memzero(History, sizeof(History));
+		FMemory::Memzero(PVLength, sizeof(PVLength));
+	}
+
+	bool ShouldStop()
+	{
+		if (Owner.IsStopRequested())
+			return true;
+
+		if (!bMainThread)
+			return false;
+
+		if ((Nodes & (TraceProgressInterval - 1)) == 0)
+			TraceProgress(Result.Score, false);
+
+		// The clock is comparatively expensive, so only read it every few thousand nodes.
+		const bool bOutOfNodes = Limits.Nodes > 0 && Nodes >= Limits.Nodes;
+		const bool bOutOfTime = Limits.MoveTimeMs > 0 && (Nodes & (StopCheckInterval - 1)) == 0
+			&& (FPlatformTime::Seconds() - StartTime) * 1000.0 >= Limits.MoveTimeMs;
+		if (bOutOfNodes || bOutOfTime)
+		{
+			Owner.Stop();
+			return true;
+		}
+		return false;
+	}
+
+	void TraceProgress(int32 Score, bool bIterationComplete) const
+	{
+#if UE_TRACE_ENABLED
+		const double Elapsed = FPlatformTime::Seconds() - StartTime;
+		UE_TRACE_LOG(ChessSearch, Progress, ChessSearchChannel)
+			<< Progress.Cycle(FPlatformTime::Cycles64())
+			<< Progress.Nodes(Nodes)
+			<< Progress.NodesPerSecond((uint64)(Nodes / FMath::Max(Elapsed, 0.001)))
+			<< Progress.TTHitRate(TTProbes > 0 ? (float)TTHits / (float)TTProbes : 0.f)
+			<< Progress.Depth(CurrentDepth)
+			<< Progress.SelDepth(SelDepth)
+			<< Progress.Score(Score)
+			<< Progress.IterationComplete(bIterationComplete);
+#endif
+	}
+
+	bool IsRepetition() const
+	{
+		// Only positions since the last irreversible move can repeat, and only with the same side to move.
+		const int32 Last = HashStack.Num() - 1;
+		const int32 First = FMath::Max(0, Last - Position.GetHalfmoveClock());
+		for (int32 i = Last - 2; i >= First; i -= 2)
+			if (HashStack[i] == HashStack[Last])
+				return true;
+		return false;
+	}
+
+	bool HasNonPawnMaterial(EChessColor Color) const
+	{
+		for (int32 Square = 0; Square < 64; ++Square)
+		{
+			const FChessPiece& Piece = Position.GetPiece(Square);
+			if (!Piece.IsEmpty() && Piece.Color == Color && Piece.Type != EChessPieceType::Pawn && Piece.Type != EChessPieceType::King)
+				return true;
+		}
+		return false;
+	}
+
+	void ScoreMoves(const FChessMoveList& Moves, TArray<int32, TInlineAllocator<256>>& OutScores, const FChessMove& HashMove, int32 Ply) const
+	{
+		OutScores.SetNumUninitialized(Moves.Num());
+		for (int32 i = 0; i < Moves.Num(); ++i)
+		{
+			const FChessMove& Move = Moves[i];
+			if (Move == HashMove)
+			{
+				OutScores[i] = HashMoveScore;
+			}
+			else if (Move.IsCapture() || Move.IsPromotion())
+			{
+				// Most valuable victim, least valuable attacker.
+				const FChessPiece& Victim = Position.GetPiece(Move.To);
+				const int32 VictimValue = Victim.IsEmpty() ? PieceValues[(uint8)EChessPieceType::Pawn] : PieceValues[(uint8)Victim.Type];
+				const int32 AttackerValue = PieceValues[(uint8)Position.GetPiece(Move.From).Type];
+				OutScores[i] = CaptureScore + VictimValue * 16 - AttackerValue / 16 + (Move.IsPromotion() ? PieceValues[(uint8)Move.Promotion] : 0);
+			}
+			else if (Move == Killers[Ply][0] || Move == Killers[Ply][1])
+			{
+				OutScores[i] = KillerScore;
+			}
+			else
+			{
+				OutScores[i] = History[Move.From][Move.To];
+			}
+		}
+	}
+
+	static void PickMove(FChessMoveList& Moves, TArray<int32, TInlineAllocator<256>>& Scores, int32 Index)
+	{
+		int32 Best = Index;
+		for (int32 i = Index + 1; i < Moves.Num(); ++i)
+			if (Scores[i] > Scores[Best])
+				Best = i;
+		if (Best != Index)
+		{
+			Swap(Moves[Index], Moves[Best]);
+			Swap(Scores[Index], Scores[Best]);
+		}
+	}
+
+	int32 Quiescence(int32 Alpha, int32 Beta, int32 Ply)
+	{
+		++Nodes;
+		SelDepth = FMath::Max(SelDepth, Ply);
+		if (ShouldStop())
+			return 0;
+
+		const int32 StandPat = Evaluate(Position);
+		if (Ply >= MaxPly || StandPat >= Beta)
+			return StandPat;
+		Alpha = FMath::Max(Alpha, StandPat);
+
+		FChessMoveList Moves;
+		FChessMoveGenerator::GeneratePseudoLegal(Position, Moves, true);
+		TArray<int32, TInlineAllocator<256>> Scores;
+		ScoreMoves(Moves, Scores, FChessMove(), Ply);
+
+		const EChessColor Us = Position.GetSideToMove();
+		for (int32 i = 0; i < Moves.Num(); ++i)
+		{
+			PickMove(Moves, Scores, i);
+			const FChessMove& Move = Moves[i];
+
+			FChessPosition::FUndo Undo;
+			Position.MakeMove(Move, Undo);
+			if (Position.IsInCheck(Us))
+			{
+				Position.UnmakeMove(Move, Undo);
+				continue;
+			}
+
+			const int32 Score = -Quiescence(-Beta, -Alpha, Ply + 1);
+			Position.UnmakeMove(Move, Undo);
+
+			if (Owner.IsStopRequested())
+				return 0;
+			if (Score >= Beta)
+				return Score;
+			Alpha = FMath::Max(Alpha, Score);
+		}
+		return Alpha;
+	}
+
+	int32 Negamax(int32 Depth, int32 Alpha, int32 Beta, int32 Ply, bool bAllowNull)
+	{
+		PVLength[Ply] = 0;
+		const bool bRoot = Ply == 0;
+
+		if (!bRoot && (Position.GetHalfmoveClock() >= 100 || IsRepetition()))
+			return 0;
+
+		const EChessColor Us = Position.GetSideToMove();
+		const bool bInCheck = Position.IsInCheck(Us);
+		if (bInCheck)
+			++Depth;
+
+		if (Depth <= 0)
+			return Quiescence(Alpha, Beta, Ply);
+
+		++Nodes;
+		SelDepth = FMath::Max(SelDepth, Ply);
+		if (ShouldStop())
+			return 0;
+		if (Ply >= MaxPly)
+			return Evaluate(Position);
+
+		const bool bPVNode = Beta - Alpha > 1;
+		FChessMove HashMove;
+		FChessTranspositionTable::FProbe Probe;
+		++TTProbes;
+		if (Owner.TranspositionTable.Probe(Position.GetHash(), Probe))
+		{
+			++TTHits;
+			HashMove = Probe.Move;
+			if (!bRoot && !bPVNode && Probe.Depth >= Depth)
+			{
+				const int32 Score = ScoreFromTable(Probe.Score, Ply);
+				if (Probe.Bound == FChessTranspositionTable::EBound::Exact
+					|| (Probe.Bound == FChessTranspositionTable::EBound::Lower && Score >= Beta)
+					|| (Probe.Bound == FChessTranspositionTable::EBound::Upper && Score <= Alpha))
+				{
+					return Score;
+				}
+			}
+		}
+
+		// Null-move pruning: if passing still fails high, a real move will too.
+		if (bAllowNull && !bPVNode && !bInCheck && Depth >= 3 && HasNonPawnMaterial(Us) && Evaluate(Position) >= Beta)
+		{
+			FChessPosition::FUndo Undo;
+			Position.MakeNullMove(Undo);
+			HashStack.Add(Position.GetHash());
+			const int32 Score = -Negamax(Depth - 3, -Beta, -Beta + 1, Ply + 1, false);
+			HashStack.Pop(EAllowShrinking::No);
+			Position.UnmakeNullMove(Undo);
+
+			if (Owner.IsStopRequested())
+				return 0;
+			if (Score >= Beta && !IsMateScore(Score))
+				return Beta;
+		}
+
+		FChessMoveList Moves;
+		FChessMoveGenerator::GeneratePseudoLegal(Position, Moves);
+		TArray<int32, TInlineAllocator<256>> Scores;
+		ScoreMoves(Moves, Scores, HashMove, Ply);
+
+		const int32 OriginalAlpha = Alpha;
+		int32 BestScore = -InfiniteScore;
+		FChessMove BestMove;
+		int32 LegalMoves = 0;
+
+		for (int32 i = 0; i < Moves.Num(); ++i)
+		{
+			PickMove(Moves, Scores, i);
+			const FChessMove Move = Moves[i];
+			if (bRoot && ExcludedRootMoves.Contains(Move))
+				continue;
+
+			FChessPosition::FUndo Undo;
+			Position.MakeMove(Move, Undo);
+			if (Position.IsInCheck(Us))
+			{
+				Position.UnmakeMove(Move, Undo);
+				continue;
+			}
+			++LegalMoves;
+			HashStack.Add(Position.GetHash());
+
+			const bool bQuiet = !Move.IsCapture() && !Move.IsPromotion();
+			int32 Score;
+			if (LegalMoves == 1)
+			{
+				Score = -Negamax(Depth - 1, -Beta, -Alpha, Ply + 1, true);
+			}
+			else
+			{
+				// Late quiet moves are searched shallower first and re-searched if they surprise us.
+				const int32 Reduction = (bQuiet && !bInCheck && Depth >= 3 && LegalMoves > 4) ? 1 : 0;
+				Score = -Negamax(Depth - 1 - Reduction, -Alpha - 1, -Alpha, Ply + 1, true);
+				if (Score > Alpha && Reduction > 0)
+					Score = -Negamax(Depth - 1, -Alpha - 1, -Alpha, Ply + 1, true);
+				if (Score > Alpha && Score < Beta)
+					Score = -Negamax(Depth - 1, -Beta, -Alpha, Ply + 1, true);
+			}
+
+			HashStack.Pop(EAllowShrinking::No);
+			Position.UnmakeMove(Move, Undo);
+
+			if (Owner.IsStopRequested())
+				return 0;
+
+			if (Score > BestScore)
+			{
+				BestScore = Score;
+				BestMove = Move;
+			}
+
+			if (Score > Alpha)
+			{
+				Alpha = Score;
+
+				PV[Ply][0] = Move;
+				for (int32 j = 0; j < PVLength[Ply + 1]; ++j)
+					PV[Ply][j + 1] = PV[Ply + 1][j];
+				PVLength[Ply] = PVLength[Ply + 1] + 1;
+
+				if (Alpha >= Beta)
+				{
+					if (bQuiet)
+					{
+						if (Killers[Ply][0] != Move)
+						{
+							Killers[Ply][1] = Killers[Ply][0];
+							Killers[Ply][0] = Move;
+						}
+						History[Move.From][Move.To] += Depth * Depth;
+					}
+					break;
+				}
+			}
+		}
+
+		if (LegalMoves == 0)
+			return bInCheck ? -MateScore + Ply : 0;
+
+		// A root searched without its best moves says nothing reliable about the position.
+		if (bRoot && ExcludedRootMoves.Num() > 0)
+			return BestScore;
+
+		const FChessTranspositionTable::EBound Bound =
+			BestScore >= Beta ? FChessTranspositionTable::EBound::Lower :
+			BestScore > OriginalAlpha ? FChessTranspositionTable::EBound::Exact :
+			FChessTranspositionTable::EBound::Upper;
+		Owner.TranspositionTable.Store(Position.GetHash(), BestMove, ScoreToTable(BestScore, Ply), Depth, Bound);
+
+		return BestScore;
+	}
+
+	void IterativeDeepening(int32 DepthOffset, const FOnInfo& OnInfo)
+	{
+		HashStack.Add(Position.GetHash());
+
+		// Helpers only exist to fill the table; the extra lines are the main thread's job.
+		int32 NumLines = 1;
+		if (bMainThread && Limits.MultiPV > 1)
+		{
+			FChessMoveList RootMoves;
+			FChessMoveGenerator::GenerateLegal(Position, RootMoves);
+			NumLines = FMath::Clamp(RootMoves.Num(), 1, Limits.MultiPV);
+		}
+
+		const int32 MaxDepth = Limits.Depth > 0 ? FMath::Min(Limits.Depth, MaxPly - 1) : MaxPly - 1;
+		for (int32 Depth = 1 + DepthOffset; Depth <= MaxDepth; ++Depth)
+		{
+			TRACE_CPUPROFILER_EVENT_SCOPE(FChessSearch::Iteration);
+
+			CurrentDepth = Depth;
+			ExcludedRootMoves.Reset();
+
+			TArray<FChessSearchLine> Lines;
+			for (int32 LineIndex = 0; LineIndex < NumLines; ++LineIndex)
+			{
+				SelDepth = 0;
+				const int32 Score = Negamax(Depth, -InfiniteScore, InfiniteScore, 0, false);
+
+				// A partial iteration is only trusted if it is all we have.
+				if (Owner.IsStopRequested() && (!Result.BestMove.IsNull() || LineIndex > 0))
+					break;
+				if (PVLength[0] == 0)
+					break;
+
+				FChessSearchLine& Line = Lines.AddDefaulted_GetRef();
+				Line.Score = Score;
+				Line.PrincipalVariation.Append(PV[0], PVLength[0]);
+				ExcludedRootMoves.Add(PV[0][0]);
+
+				if (bMainThread && OnInfo)
+				{
+					FChessSearchInfo Info;
+					Info.MultiPVIndex = LineIndex + 1;
+					Info.Depth = Depth;
+					Info.SelDepth = SelDepth;
+					Info.Score = Score;
+					Info.Nodes = Nodes;
+					Info.ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+					Info.TTProbes = TTProbes;
+					Info.TTHits = TTHits;
+					Info.HashFullPermill = Owner.TranspositionTable.GetHashFullPermill();
+					Info.PrincipalVariation = Line.PrincipalVariation;
+					OnInfo(Info);
+				}
+
+				if (Owner.IsStopRequested())
+					break;
+			}
+
+			// Keep the previous iteration unless this one finished, or nothing finished before it.
+			if (Lines.Num() == 0 || (Lines.Num() < NumLines && !Result.BestMove.IsNull()))
+				break;
+
+			// Each line excluded the better ones, so they come out best first; a re-sort only fixes search instability.
+			Lines.StableSort([](const FChessSearchLine& A, const FChessSearchLine& B) { return A.Score > B.Score; });
+
+			const FChessSearchLine& Best = Lines[0];
+			Result.BestMove = Best.PrincipalVariation[0];
+			Result.PonderMove = Best.PrincipalVariation.Num() > 1 ? Best.PrincipalVariation[1] : FChessMove();
+			Result.Score = Best.Score;
+			Result.Depth = Depth;
+			Result.Lines = MoveTemp(Lines);
+
+			if (bMainThread)
+				TraceProgress(Result.Score, true);
+
+			if (Owner.IsStopRequested())
+				break;
+
+			// A forced mate shorter than the search depth will not get any better.
+			if (!Limits.bInfinite && IsMateScore(Result.Score) && MateScore - FMath::Abs(Result.Score) <= Depth)
+				break;
+		}
+	}
+};
+
+FChessSearch::FChessSearch() = default;
+
+FChessSearch::~FChessSearch()
+{
+	Stop();
+}
+
+void FChessSearch::SetHashSizeMB(int32 SizeMB)
+{
+	TranspositionTable.Resize(SizeMB);
+}
+
+void FChessSearch::SetThreadCount(int32 Count)
+{
+	ThreadCount = FMath::Clamp(Count, 1, 256);
+}
+
+void FChessSearch::ClearHash()
+{
+	TranspositionTable.Clear();
+}
+
+FChessSearchResult FChessSearch::Search(const FChessPosition& Root, const TArray<uint64>& History, const FChessSearchLimits& Limits, const FOnInfo& OnInfo)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FChessSearch::Search);
+
+	const double StartTime = FPlatformTime::Seconds();
+	TranspositionTable.NewSearch();
+
+	TArray<TUniquePtr<FWorker>> Helpers;
+	TArray<TFuture<void>> HelperTasks;
+	for (int32 i = 1; i < ThreadCount; ++i)
+	{
+		FWorker* Helper = Helpers.Add_GetRef(MakeUnique<FWorker>(*this, Root, History, Limits, false, StartTime)).Get();
+		// Odd helpers start one ply deeper so the threads desynchronise and fill the table for each other.
+		const int32 DepthOffset = i & 1;
+		HelperTasks.Add(Async(EAsyncExecution::Thread, [Helper, DepthOffset]()
+			{
+				TRACE_CPUPROFILER_EVENT_SCOPE(FChessSearch::Helper);
+				Helper->IterativeDeepening(DepthOffset, FOnInfo());
+			}));
+	}
+
+	TUniquePtr<FWorker> Main = MakeUnique<FWorker>(*this, Root, History, Limits, true, StartTime);
+	Main->IterativeDeepening(0, OnInfo);
+
+	// UCI expects "go infinite" to keep going until told to stop, even if there is nothing left to search.
+	while (Limits.bInfinite && !IsStopRequested())
+		FPlatformProcess::Sleep(0.001f);
+
+	Stop();
+	for (TFuture<void>& Task : HelperTasks)
+		Task.Wait();
+
+	FChessSearchResult Result = Main->Result;
+	Result.Nodes = Main->Nodes;
+	for (const TUniquePtr<FWorker>& Helper : Helpers)
+		Result.Nodes += Helper->Nodes;
+	Result.ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+
+	// Fall back to any legal move if we were stopped before finishing depth 1.
+	if (Result.BestMove.IsNull())
+	{
+		FChessMoveList Moves;
+		FChessMoveGenerator::GenerateLegal(Root, Moves);
+		if (Moves.Num() > 0)
+			Result.BestMove = Moves[0];
+	}
+
+	return Result;
+}
+
+int32 FChessSearch::Evaluate(const FChessPosition& Position)
+{
+	int32 NonPawnMaterial = 0;
+	for (int32 Square = 0; Square < 64; ++Square)
+	{
+		const FChessPiece& Piece = Position.GetPiece(Square);
+		if (!Piece.IsEmpty() && Piece.Type != EChessPieceType::Pawn)
+			NonPawnMaterial += PieceValues[(uint8)Piece.Type];
+	}
+	const int32* KingTable = NonPawnMaterial <= EndgameMaterial ? KingEndgameTable : KingMiddlegameTable;
+
+	int32 Score = 0;
+	for (int32 Square = 0; Square < 64; ++Square)
+	{
+		const FChessPiece& Piece = Position.GetPiece(Square);
+		if (Piece.IsEmpty())
+			continue;
+
+		// Tables are written rank 8 first from White's side; mirror for Black.
+		const int32 Row = ChessSquare::Row(Square);
+		const int32 TableIndex = (Piece.Color == EChessColor::White ? 7 - Row : Row) * 8 + ChessSquare::Col(Square);
+
+		int32 Value = PieceValues[(uint8)Piece.Type];
+		switch (Piece.Type)
+		{
+		case EChessPieceType::Pawn:   Value += PawnTable[TableIndex]; break;
+		case EChessPieceType::Knight: Value += KnightTable[TableIndex]; break;
+		case EChessPieceType::Bishop: Value += BishopTable[TableIndex]; break;
+		case EChessPieceType::Rook:   Value += RookTable[TableIndex]; break;
+		case EChessPieceType::Queen:  Value += QueenTable[TableIndex]; break;
+		case EChessPieceType::King:   Value += KingTable[TableIndex]; break;
+		default: break;
+		}
+
+		Score += Piece.Color == EChessColor::White ? Value : -Value;
+	}
+
+	return (Position.GetSideToMove() == EChessColor::White ? Score : -Score) + TempoBonus;
+}
@@ -0,0 +1,119 @@
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "ChessAnalysis.h"
+#include "ChessMatch.h"
+#include "ChessMoveGenerator.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+
+namespace ChessAnalysisTest
+{
+	/** Polls like the board overlay does, for at most TimeoutSeconds. */
+	bool WaitUntilIdle(const FChessAnalysisService& Service, double TimeoutSeconds)
+	{
+		const double Deadline = FPlatformTime::Seconds() + TimeoutSeconds;
+		while (Service.IsAnalyzing())
+		{
+			if (FPlatformTime::Seconds() > Deadline)
+				return false;
+			FPlatformProcess::Sleep(0.001f);
+		}
+		return true;
+	}
+
+	const TCHAR* const Kiwipete = TEXT("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessAnalysisServiceTest, "Chess.Core.Analysis.Service",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FChessAnalysisServiceTest::RunTest(const FString& Parameters)
+{
+	using namespace ChessAnalysisTest;
+
+	// Shallow enough to finish quickly, so results and the cache can be checked at full depth.
+	{
+		FChessAnalysisSettings Settings;
+		Settings.MaxDepth = 4;
+		Settings.MultiPV = 3;
+		Settings.HashSizeMB = 1;
+		FChessAnalysisService Service(Settings);
+
+		FChessMatch Match;
+		Match.MakeMove(FChessMoveGenerator::ParseUciMove(Match.GetPosition(), TEXT("e2e4")));
+		const uint64 Hash = Match.GetPosition().GetHash();
+
+		Service.Analyze(Match.GetPosition(), Match.GetHashHistory());
+		if (!TestTrue(TEXT("Analysis finishes"), WaitUntilIdle(Service, 30.0)))
+			return false;
+
+		FChessAnalysis Analysis;
+		if (!TestTrue(TEXT("Analysis is cached under the position's hash"), Service.GetAnalysis(Hash, Analysis)))
+			return false;
+		TestEqual(TEXT("Hash matches"), Analysis.Hash, Hash);
+		TestTrue(TEXT("Side to move is Black"), Analysis.SideToMove == EChessColor::Black);
+		TestEqual(TEXT("Searched to full depth"), Analysis.Depth, Settings.MaxDepth);
+		TestEqual(TEXT("One line per MultiPV"), Analysis.Lines.Num(), Settings.MultiPV);
+		for (int32 i = 0; i < Analysis.Lines.Num(); ++i)
+		{
+			const FChessSearchLine& Line = Analysis.Lines[i];
+			if (!TestTrue(TEXT("Line has a principal variation"), Line.PrincipalVariation.Num() > 0))
+				continue;
+			TestTrue(TEXT("Line starts with a legal Black move"), !FChessMoveGenerator::ParseUciMove(Match.GetPosition(), Line.PrincipalVariation[0].ToUci()).IsNull());
+			if (i > 0)
+				TestTrue(TEXT("Lines are best first"), Analysis.Lines[i - 1].Score >= Line.Score);
+		}
+		TestEqual(TEXT("White score flips the side-to-move score"), Analysis.GetWhiteScore(), -Analysis.Lines[0].Score);
+		TestFalse(TEXT("Nothing newer than the full-depth result"), Service.GetAnalysis(Hash, Analysis, Settings.MaxDepth));
+
+		// Coming back to it (a takeback, or a transposition) is answered from the cache.
+		Match.UndoMove();
+		Service.Analyze(Match.GetPosition(), Match.GetHashHistory());
+		WaitUntilIdle(Service, 30.0);
+		Match.MakeMove(FChessMoveGenerator::ParseUciMove(Match.GetPosition(), TEXT("e2e4")));
+		Service.Analyze(Match.GetPosition(), Match.GetHashHistory());
+		TestFalse(TEXT("A position cached at full depth starts no search"), Service.IsAnalyzing());
+		TestTrue(TEXT("The cached result is still there"), Service.GetAnalysis(Hash, Analysis) && Analysis.Depth == Settings.MaxDepth);
+
+		// A finished game has nothing to analyse.
+		FChessMatch Mated;
+		Mated.ResetFromFen(TEXT("3R2k1/5ppp/8/8/8/8/5PPP/6K1 b - - 1 1"));
+		Service.Analyze(Mated.GetPosition(), Mated.GetHashHistory());
+		TestFalse(TEXT("A checkmated position starts no search"), Service.IsAnalyzing());
+	}
+
+	// Deep enough never to finish on its own: stopping and shutting down must not wait for it.
+	{
+		FChessAnalysisSettings Settings;
+		Settings.MaxDepth = 64;
+		Settings.HashSizeMB = 1;
+
+		FChessMatch Match;
+		Match.ResetFromFen(Kiwipete);
+
+		FChessAnalysisService* Service = new FChessAnalysisService(Settings);
+		Service->Analyze(Match.GetPosition(), Match.GetHashHistory());
+		FPlatformProcess::Sleep(0.2f);
+		TestTrue(TEXT("Deep analysis is still running"), Service->IsAnalyzing());
+
+		double Start = FPlatformTime::Seconds();
+		Service->Stop();
+		TestTrue(TEXT("Stop returns and the search unwinds promptly"), WaitUntilIdle(*Service, 2.0));
+		AddInfo(FString::Printf(TEXT("Stop took %.1f ms"), (FPlatformTime::Seconds() - Start) * 1000.0));
+
+		Service->Analyze(Match.GetPosition(), Match.GetHashHistory());
+		FPlatformProcess::Sleep(0.2f);
+		TestTrue(TEXT("Analysis restarts after a stop"), Service->IsAnalyzing());
+
+		Start = FPlatformTime::Seconds();
+		delete Service;
+		const double DestroySeconds = FPlatformTime::Seconds() - Start;
+		TestTrue(FString::Printf(TEXT("Destroying the service mid-search is prompt (%.1f ms)"), DestroySeconds * 1000.0), DestroySeconds < 2.0);
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
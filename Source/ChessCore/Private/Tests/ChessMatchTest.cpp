@@ -0,0 +1,141 @@
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "ChessMatch.h"
+#include "ChessMoveGenerator.h"
+
+namespace ChessMatchTest
+{
+	/** Plays space-separated UCI moves, failing the test at the first one the match refuses. */
+	bool PlayMoves(FAutomationTestBase& Test, FChessMatch& Match, const TCHAR* Moves)
+	{
+		TArray<FString> Texts;
+		FString(Moves).ParseIntoArrayWS(Texts);
+		for (const FString& Text : Texts)
+		{
+			const FChessMove Move = FChessMoveGenerator::ParseUciMove(Match.GetPosition(), Text);
+			if (!Test.TestTrue(FString::Printf(TEXT("%s is legal"), *Text), !Move.IsNull() && Match.MakeMove(Move)))
+				return false;
+		}
+		return true;
+	}
+
+	struct FStatusCase
+	{
+		const TCHAR* Name;
+		const TCHAR* Fen;
+		const TCHAR* Moves;
+		EChessGameStatus Expected;
+	};
+
+	const FStatusCase StatusCases[] =
+	{
+		{ TEXT("fool's mate"),            TEXT("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"), TEXT("f2f3 e7e5 g2g4 d8h4"), EChessGameStatus::Checkmate },
+		{ TEXT("stalemate"),              TEXT("7k/8/6K1/8/8/8/8/5Q2 w - - 0 1"),  TEXT("f1f7"), EChessGameStatus::Stalemate },
+		{ TEXT("fifty moves"),            TEXT("4k3/8/8/8/8/8/8/R3K3 w - - 99 80"), TEXT("a1a2"), EChessGameStatus::FiftyMoveRule },
+		{ TEXT("mate on the 100th ply"),  TEXT("k7/8/1K6/8/8/8/8/7R w - - 99 80"),  TEXT("h1h8"), EChessGameStatus::Checkmate },
+		{ TEXT("pawn move resets clock"), TEXT("4k3/8/8/8/8/8/P7/4K3 w - - 99 80"), TEXT("a2a3"), EChessGameStatus::InProgress },
+		{ TEXT("capture down to K v K"),  TEXT("4k3/8/8/8/8/8/8/3rK3 w - - 0 1"),   TEXT("e1d1"), EChessGameStatus::InsufficientMaterial },
+	};
+
+	struct FMaterialCase
+	{
+		const TCHAR* Name;
+		const TCHAR* Fen;
+		bool bInsufficient;
+	};
+
+	const FMaterialCase MaterialCases[] =
+	{
+		{ TEXT("K v K"),                    TEXT("4k3/8/8/8/8/8/8/4K3 w - - 0 1"),   true },
+		{ TEXT("K+B v K"),                  TEXT("4k3/8/8/8/8/8/8/2B1K3 w - - 0 1"), true },
+		{ TEXT("K+N v K"),                  TEXT("4k3/8/8/8/8/8/8/1N2K3 w - - 0 1"), true },
+		{ TEXT("K v K+N"),                  TEXT("1n2k3/8/8/8/8/8/8/4K3 w - - 0 1"), true },
+		{ TEXT("same-colour bishops"),      TEXT("2b1k3/8/8/8/8/8/8/4KB2 w - - 0 1"), true },
+		{ TEXT("same-colour bishops, one side"), TEXT("4k3/8/8/8/8/4B3/8/2B1K3 w - - 0 1"), true },
+		{ TEXT("two bishops, one side"),    TEXT("4k3/8/8/8/8/8/4B3/2B1K3 w - - 0 1"), false },
+		{ TEXT("opposite-colour bishops"),  TEXT("2b1k3/8/8/8/8/8/8/2B1K3 w - - 0 1"), false },
+		{ TEXT("K+B+N v K"),                TEXT("4k3/8/8/8/8/8/8/1NB1K3 w - - 0 1"), false },
+		{ TEXT("K+N+N v K"),                TEXT("4k3/8/8/8/8/8/8/1N2K1N1 w - - 0 1"), false },
+		{ TEXT("K+P v K"),                  TEXT("4k3/8/8/8/8/8/4P3/4K3 w - - 0 1"), false },
+		{ TEXT("K+R v K"),                  TEXT("4k3/8/8/8/8/8/8/R3K3 w - - 0 1"),  false },
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessMatchStatusTest, "Chess.Core.Match.Status",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FChessMatchStatusTest::RunTest(const FString& Parameters)
+{
+	using namespace ChessMatchTest;
+
+	for (const FStatusCase& Case : StatusCases)
+	{
+		FChessMatch Match;
+		if (!TestTrue(FString::Printf(TEXT("%s: FEN parses"), Case.Name), Match.ResetFromFen(Case.Fen)))
+			continue;
+		TestTrue(FString::Printf(TEXT("%s: in progress before the move"), Case.Name), Match.GetStatus() == EChessGameStatus::InProgress);
+		if (!PlayMoves(*this, Match, Case.Moves))
+			continue;
+
+		TestEqual(FString::Printf(TEXT("%s: status"), Case.Name), (int32)Match.GetStatus(), (int32)Case.Expected);
+
+		Match.UndoMove();
+		TestTrue(FString::Printf(TEXT("%s: undo puts the game back in progress"), Case.Name), Match.GetStatus() == EChessGameStatus::InProgress);
+	}
+
+	for (const FMaterialCase& Case : MaterialCases)
+	{
+		FChessMatch Match;
+		if (!TestTrue(FString::Printf(TEXT("%s: FEN parses"), Case.Name), Match.ResetFromFen(Case.Fen)))
+			continue;
+		const EChessGameStatus Expected = Case.bInsufficient ? EChessGameStatus::InsufficientMaterial : EChessGameStatus::InProgress;
+		TestEqual(FString::Printf(TEXT("%s: status"), Case.Name), (int32)Match.GetStatus(), (int32)Expected);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessMatchRepetitionTest, "Chess.Core.Match.Repetition",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FChessMatchRepetitionTest::RunTest(const FString& Parameters)
+{
+	using namespace ChessMatchTest;
+
+	// Knights out and back twice: the start position comes round for the third time on ply 8.
+	FChessMatch Match;
+	const uint64 StartHash = Match.GetPosition().GetHash();
+	if (!PlayMoves(*this, Match, TEXT("g1f3 g8f6 f3g1 f6g8 g1f3 g8f6 f3g1")))
+		return false;
+	TestTrue(TEXT("Twice is not yet a repetition"), Match.GetStatus() == EChessGameStatus::InProgress);
+
+	if (!PlayMoves(*this, Match, TEXT("f6g8")))
+		return false;
+	TestTrue(TEXT("Third occurrence is a repetition"), Match.GetStatus() == EChessGameStatus::Repetition);
+	TestEqual(TEXT("One history hash per move played"), Match.GetHashHistory().Num(), 8);
+
+	// Taking the move back must drop its hash too, or the repetition would be counted again.
+	Match.UndoMove();
+	TestTrue(TEXT("Undo clears the repetition"), Match.GetStatus() == EChessGameStatus::InProgress);
+	TestEqual(TEXT("Undo pops the history"), Match.GetHashHistory().Num(), 7);
+	TestEqual(TEXT("History still starts at the start position"), Match.GetHashHistory()[0], StartHash);
+
+	if (!PlayMoves(*this, Match, TEXT("f6g8")))
+		return false;
+	TestTrue(TEXT("Replaying the move repeats again"), Match.GetStatus() == EChessGameStatus::Repetition);
+
+	// A pawn move makes every earlier position unreachable.
+	FChessMatch Pawn;
+	if (!PlayMoves(*this, Pawn, TEXT("g1f3 g8f6 f3g1 f6g8 e2e4 e7e5 g1f3 g8f6 f3g1 f6g8 g1f3 g8f6 f3g1")))
+		return false;
+	TestTrue(TEXT("Positions before a pawn move do not count"), Pawn.GetStatus() == EChessGameStatus::InProgress);
+	if (!PlayMoves(*this, Pawn, TEXT("f6g8")))
+		return false;
+	TestTrue(TEXT("Three occurrences after the pawn move do"), Pawn.GetStatus() == EChessGameStatus::Repetition);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,43 @@
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "ChessMoveGenerator.h"
+
+namespace ChessPerftTest
+{
+	struct FPerftCase
+	{
+		const TCHAR* Name;
+		const TCHAR* Fen;
+		uint64 Nodes[4];
+	};
+
+	// Published counts for depths 1 to 4. Kiwipete covers castling, en passant, promotion and pins.
+	const FPerftCase Cases[] =
+	{
+		{ TEXT("start"), TEXT("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"), { 20, 400, 8902, 197281 } },
+		{ TEXT("kiwipete"), TEXT("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"), { 48, 2039, 97862, 4085603 } },
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessPerftTest, "Chess.Core.MoveGenerator.Perft",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FChessPerftTest::RunTest(const FString& Parameters)
+{
+	for (const ChessPerftTest::FPerftCase& Case : ChessPerftTest::Cases)
+	{
+		FChessPosition Position;
+		if (!TestTrue(FString::Printf(TEXT("%s FEN parses"), Case.Name), Position.SetFromFen(Case.Fen)))
+			continue;
+
+		for (int32 Depth = 1; Depth <= UE_ARRAY_COUNT(Case.Nodes); ++Depth)
+			TestEqual(FString::Printf(TEXT("%s perft(%d)"), Case.Name, Depth), FChessMoveGenerator::Perft(Position, Depth), Case.Nodes[Depth - 1]);
+
+		TestEqual(FString::Printf(TEXT("%s position restored after perft"), Case.Name), Position.ToFen(), FString(Case.Fen));
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
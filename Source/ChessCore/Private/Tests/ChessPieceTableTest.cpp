@@ -0,0 +1,238 @@
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "ChessMatch.h"
+#include "ChessMoveGenerator.h"
+#include "ChessPieceTable.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace ChessPieceTableTest
+{
+	/** Everything the table knows about every id, to check a takeback restores it exactly. */
+	struct FSnapshot
+	{
+		TArray<int32> State;
+
+		explicit FSnapshot(const FChessPieceTable& Table)
+		{
+			for (int32 Id = 0; Id < Table.Num(); ++Id)
+			{
+				State.Add(Table.GetSquare(Id));
+				State.Add((int32)Table.GetType(Id));
+				State.Add((int32)Table.GetColor(Id));
+				State.Add(Table.GetFlags(Id));
+			}
+		}
+
+		bool operator==(const FSnapshot& Other) const { return State == Other.State; }
+	};
+
+	struct FLine
+	{
+		const TCHAR* Name;
+		const TCHAR* Fen;
+		const TCHAR* Moves;
+	};
+
+	const FLine Lines[] =
+	{
+		{ TEXT("castling"), TEXT("r3k2r/pppppppp/8/8/8/8/PPPPPPPP/R3K2R w KQkq - 0 1"), TEXT("e1g1 e8c8 g1h1 c8b8") },
+		{ TEXT("en passant"), TEXT("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"), TEXT("e2e4 a7a6 e4e5 d7d5 e5d6 c7d6") },
+		{ TEXT("promotion"), TEXT("1n6/P6k/8/8/8/8/7p/4K3 w - - 0 1"), TEXT("a7b8q h2h1n b8c8 h7g6") },
+	};
+
+	TArray<uint8> Save(FChessPieceTable& Table)
+	{
+		TArray<uint8> Bytes;
+		{
+			FMemoryWriter Writer(Bytes);
+			Writer << Table;
+		}
+		return Bytes;
+	}
+
+	/** Loads into a table that already holds pieces, so a failed load has to clear them. */
+	bool Load(const TArray<uint8>& Bytes, FChessPieceTable& OutTable)
+	{
+		FChessMatch Match;
+		OutTable.SetFromPosition(Match.GetPosition());
+
+		FMemoryReader Reader(Bytes);
+		Reader << OutTable;
+		return !Reader.IsError();
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessPieceTableUndoTest, "Chess.Core.PieceTable.Undo",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FChessPieceTableUndoTest::RunTest(const FString& Parameters)
+{
+	using namespace ChessPieceTableTest;
+
+	// Scripted lines: play them out, then take every move back and expect the same ids and flags.
+	for (const FLine& Line : Lines)
+	{
+		FChessMatch Match;
+		if (!TestTrue(FString::Printf(TEXT("%s FEN parses"), Line.Name), Match.ResetFromFen(Line.Fen)))
+			continue;
+
+		FChessPieceTable Table;
+		Table.SetFromPosition(Match.GetPosition());
+
+		TArray<FString> Moves;
+		FString(Line.Moves).ParseIntoArrayWS(Moves);
+
+		TArray<FSnapshot> Before;
+		for (const FString& Text : Moves)
+		{
+			const FChessMove Move = FChessMoveGenerator::ParseUciMove(Match.GetPosition(), Text);
+			if (!TestFalse(FString::Printf(TEXT("%s: %s is legal"), Line.Name, *Text), Move.IsNull()))
+				break;
+
+			Before.Add(FSnapshot(Table));
+			Match.MakeMove(Move);
+			Table.ApplyMove(Move);
+			TestTrue(FString::Printf(TEXT("%s: in sync after %s"), Line.Name, *Text), Table.IsInSyncWith(Match.GetPosition()));
+		}
+
+		while (Before.Num() > 0)
+		{
+			Match.UndoMove();
+			Table.UndoMove();
+			TestTrue(FString::Printf(TEXT("%s: in sync after undo"), Line.Name), Table.IsInSyncWith(Match.GetPosition()));
+			TestTrue(FString::Printf(TEXT("%s: ids and flags restored by undo"), Line.Name), FSnapshot(Table) == Before.Pop());
+		}
+		TestFalse(FString::Printf(TEXT("%s: nothing left to undo"), Line.Name), Table.CanUndo());
+	}
+
+	// Random games with takebacks mixed in, from a position where every special move is close.
+	FRandomStream Random(20261019);
+	for (int32 Game = 0; Game < 200; ++Game)
+	{
+		FChessMatch Match;
+		Match.ResetFromFen(TEXT("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"));
+		FChessPieceTable Table;
+		Table.SetFromPosition(Match.GetPosition());
+
+		TArray<FSnapshot> Before;
+		for (int32 Ply = 0; Ply < 120 && !Match.IsGameOver(); ++Ply)
+		{
+			if (Before.Num() > 0 && Random.RandRange(0, 3) == 0)
+			{
+				Match.UndoMove();
+				Table.UndoMove();
+				if (!TestTrue(TEXT("Undo restores ids and flags"), FSnapshot(Table) == Before.Pop() && Table.IsInSyncWith(Match.GetPosition())))
+					return false;
+				continue;
+			}
+
+			FChessMoveList Moves;
+			Match.GetLegalMoves(Moves);
+			const FChessMove Move = Moves[Random.RandRange(0, Moves.Num() - 1)];
+
+			Before.Add(FSnapshot(Table));
+			Match.MakeMove(Move);
+			Table.ApplyMove(Move);
+			if (!TestTrue(FString::Printf(TEXT("In sync after %s"), *Move.ToUci()), Table.IsInSyncWith(Match.GetPosition())))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessPieceTableSerializeTest, "Chess.Core.PieceTable.Serialize",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FChessPieceTableSerializeTest::RunTest(const FString& Parameters)
+{
+	using namespace ChessPieceTableTest;
+
+	// Round trip mid-game: the loaded table matches and takes back the same moves with the same ids.
+	for (const FLine& Line : Lines)
+	{
+		FChessMatch Match;
+		Match.ResetFromFen(Line.Fen);
+		FChessPieceTable Table;
+		Table.SetFromPosition(Match.GetPosition());
+
+		TArray<FString> Moves;
+		FString(Line.Moves).ParseIntoArrayWS(Moves);
+		for (const FString& Text : Moves)
+		{
+			const FChessMove Move = FChessMoveGenerator::ParseUciMove(Match.GetPosition(), Text);
+			Match.MakeMove(Move);
+			Table.ApplyMove(Move);
+		}
+
+		FChessPieceTable Loaded;
+		if (!TestTrue(FString::Printf(TEXT("%s: loads"), Line.Name), Load(Save(Table), Loaded)))
+			continue;
+		TestTrue(FString::Printf(TEXT("%s: same ids and flags"), Line.Name), FSnapshot(Loaded) == FSnapshot(Table));
+		TestTrue(FString::Printf(TEXT("%s: in sync"), Line.Name), Loaded.IsInSyncWith(Match.GetPosition()));
+
+		while (Table.CanUndo())
+		{
+			Match.UndoMove();
+			Table.UndoMove();
+			if (!TestTrue(FString::Printf(TEXT("%s: loaded table has the same history"), Line.Name), Loaded.CanUndo()))
+				break;
+			Loaded.UndoMove();
+			TestTrue(FString::Printf(TEXT("%s: same takeback"), Line.Name), FSnapshot(Loaded) == FSnapshot(Table) && Loaded.IsInSyncWith(Match.GetPosition()));
+		}
+		TestFalse(FString::Printf(TEXT("%s: no extra history"), Line.Name), Loaded.CanUndo());
+	}
+
+	// Corrupt archives are refused and leave an empty table. Layout: Count, then four bytes per
+	// piece (square, type, colour, flags), then the takeback count.
+	FChessMatch Start;
+	FChessPieceTable Table;
+	Table.SetFromPosition(Start.GetPosition());
+	const TArray<uint8> Good = Save(Table);
+	const int32 FirstPiece = sizeof(int32);
+	const int32 UndoCount = FirstPiece + Table.Num() * 4;
+
+	FChessPieceTable Loaded;
+	TestTrue(TEXT("Unmodified archive loads"), Load(Good, Loaded) && FSnapshot(Loaded) == FSnapshot(Table));
+
+	struct FCorruption
+	{
+		const TCHAR* Name;
+		int32 Offset;
+		int32 Value;
+		int32 Size;
+	};
+	const FCorruption Corruptions[] =
+	{
+		{ TEXT("negative piece count"),       0,                      -1,          4 },
+		{ TEXT("too many pieces"),            0,                      33,          4 },
+		{ TEXT("square off the board"),       FirstPiece,             64,          1 },
+		{ TEXT("two pieces on one square"),   FirstPiece + 4,         Table.GetSquare(0), 1 },
+		{ TEXT("live piece with no square"),  FirstPiece,             -1,          1 },
+		{ TEXT("unknown piece type"),         FirstPiece + 1,         (int32)EChessPieceType::None, 1 },
+		{ TEXT("unknown colour"),             FirstPiece + 2,         2,           1 },
+		{ TEXT("unknown flag"),               FirstPiece + 3,         0x80,        1 },
+		{ TEXT("negative takeback count"),    UndoCount,              -1,          4 },
+		{ TEXT("huge takeback count"),        UndoCount,              MAX_int32,   4 },
+		{ TEXT("takebacks past the end"),     UndoCount,              1000,        4 },
+	};
+	for (const FCorruption& Corruption : Corruptions)
+	{
+		TArray<uint8> Bad = Good;
+		FMemory::Memcpy(&Bad[Corruption.Offset], &Corruption.Value, Corruption.Size);
+		TestFalse(FString::Printf(TEXT("Rejects %s"), Corruption.Name), Load(Bad, Loaded));
+		TestEqual(FString::Printf(TEXT("%s: leaves an empty table"), Corruption.Name), Loaded.Num(), 0);
+	}
+
+	TArray<uint8> Truncated = Good;
+	Truncated.SetNum(UndoCount);
+	TestFalse(TEXT("Rejects a truncated archive"), Load(Truncated, Loaded));
+	TestEqual(TEXT("Truncated: leaves an empty table"), Loaded.Num(), 0);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,51 @@
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "ChessPosition.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessPositionFenTest, "Chess.Core.Position.Fen",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FChessPositionFenTest::RunTest(const FString& Parameters)
+{
+	const TCHAR* Valid[] =
+	{
+		TEXT("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1"),
+		TEXT("4k3/8/8/8/8/8/8/4K2R w K - 0 1"),
+		TEXT("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"),
+		TEXT("rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3"),
+		TEXT("rnbqkbnr/pppp1ppp/8/8/3Pp3/8/PPP1PPPP/RNBQKBNR b KQkq d3 0 2"),
+	};
+	for (const TCHAR* Fen : Valid)
+	{
+		FChessPosition Position;
+		if (TestTrue(FString::Printf(TEXT("Accepts %s"), Fen), Position.SetFromFen(Fen)))
+			TestEqual(TEXT("Round-trips through ToFen"), Position.ToFen(), FString(Fen));
+	}
+
+	const TCHAR* Invalid[] =
+	{
+		TEXT("4k3/8/8/8/8/8/8/4K3 w K - 0 1"),        // castling right without a rook
+		TEXT("r3k2r/8/8/8/8/8/8/R4K1R w Q - 0 1"),    // castling right with the king off e1
+		TEXT("r3k3/8/8/8/8/8/8/4K3 w k - 0 1"),       // black short castling, no h8 rook
+		TEXT("P3k3/8/8/8/8/8/8/4K3 w - - 0 1"),       // white pawn on the last rank
+		TEXT("4k3/8/8/8/8/8/8/p3K3 b - - 0 1"),       // black pawn on the first rank
+		TEXT("8/8/8/8/8/8/8/4K3 w - - 0 1"),          // missing king
+		TEXT("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq e3 0 1"), // en passant square behind the side to move
+		TEXT("4k3/8/8/8/8/8/3p4/4K3 b - c1 0 1"),     // en passant square on the back rank
+		TEXT("4k3/3p4/8/3pP3/8/8/8/4K3 w - d6 0 1"),  // en passant past a pawn still on its start square
+		TEXT("4k3/8/8/4P3/8/8/8/4K3 w - d6 0 1"),     // en passant with no pawn to take
+		TEXT("4k3/8/8/8/8/8/8/4K3 w - z9 0 1"),       // en passant square off the board
+	};
+	for (const TCHAR* Fen : Invalid)
+	{
+		FChessPosition Position;
+		const FString Before = Position.ToFen();
+		TestFalse(FString::Printf(TEXT("Rejects %s"), Fen), Position.SetFromFen(Fen));
+		TestEqual(TEXT("A rejected FEN leaves the position untouched"), Position.ToFen(), Before);
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
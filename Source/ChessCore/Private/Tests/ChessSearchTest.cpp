@@ -0,0 +1,47 @@
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "ChessSearch.h"
+#include "Async/Async.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessSearchInfiniteStopTest, "Chess.Core.Search.InfiniteStop",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FChessSearchInfiniteStopTest::RunTest(const FString& Parameters)
+{
+	FChessSearch Search;
+	Search.SetHashSizeMB(1);
+	const FChessPosition Root;
+
+	FChessSearchLimits Limits;
+	Limits.bInfinite = true;
+
+	// "go infinite" then "stop" straight away, launched the way FUciEngine does it: the stop
+	// usually lands before the worker thread has entered Search(), and must not be lost.
+	for (int32 Attempt = 0; Attempt < 50; ++Attempt)
+	{
+		Search.BeginSearch();
+		TFuture<FChessSearchResult> Task = Async(EAsyncExecution::Thread, [&Search, &Root, Limits]()
+			{
+				return Search.Search(Root, TArray<uint64>(), Limits);
+			});
+		Search.Stop();
+
+		if (!Task.WaitFor(FTimespan::FromSeconds(10.0)))
+		{
+			AddError(FString::Printf(TEXT("Infinite search ignored a stop sent before it started (attempt %d)"), Attempt + 1));
+
+			// Unstick the worker before Search goes out of scope.
+			while (!Task.IsReady())
+				Search.Stop();
+			return false;
+		}
+
+		TestFalse(TEXT("A stopped search still returns a legal move"), Task.Get().BestMove.IsNull());
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
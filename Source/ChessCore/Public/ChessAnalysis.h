@@ -0,0 +1,109 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ChessPosition.h"
+#include "ChessSearch.h"
+#include "Async/Future.h"
+#include "Containers/LruCache.h"
+#include "HAL/CriticalSection.h"
+#include "HAL/Event.h"
+
+/** Multi-PV analysis of one position. Line scores are from the side to move's point of view. */
+struct FChessAnalysis
+{
+	uint64 Hash = 0;
+	int32 Depth = 0;
+	EChessColor SideToMove = EChessColor::White;
+
+	/** Best line first. */
+	TArray<FChessSearchLine> Lines;
+
+	bool IsValid() const { return Lines.Num() > 0; }
+
+	/** Score of the best line from White's point of view, as an evaluation bar shows it. */
+	int32 GetWhiteScore() const
+	{
+		if (!IsValid())
+			return 0;
+		return SideToMove == EChessColor::White ? Lines[0].Score : -Lines[0].Score;
+	}
+};
+
+struct FChessAnalysisSettings
+{
+	int32 MultiPV = 3;
+	int32 MaxDepth = 10;
+	int32 HashSizeMB = 16;
+
+	/** Positions kept in the result cache. */
+	int32 CacheSize = 256;
+};
+
+/**
+ * Analyses positions on a low-priority background thread while the player thinks. Results are
+ * cached by position hash in an LRU, so a position that comes back after a takeback or through a
+ * transposition is answered straight from the cache. Meant to be driven from the game thread.
+ *
+ * One worker thread lives as long as the service. Requests are handed over without waiting: a new
+ * position replaces any request not yet started and stops the search in progress, and the worker
+ * moves on to the newest request as soon as that search has unwound.
+ */
+class CHESSCORE_API FChessAnalysisService
+{
+public:
+	explicit FChessAnalysisService(const FChessAnalysisSettings& InSettings = FChessAnalysisSettings());
+	~FChessAnalysisService();
+
+	/**
+	 * Switches analysis to Position, stopping any search in progress. Nothing is searched when
+	 * the cache already holds the position at full depth. Never blocks on the worker.
+	 */
+	void Analyze(const FChessPosition& Position, const TArray<uint64>& History);
+
+	/** Drops any pending request and tells the current search to stop. Never blocks on the worker. */
+	void Stop();
+
+	/** Copies the cached analysis of a position if it is deeper than NewerThanDepth. Cheap enough to poll every frame. */
+	bool GetAnalysis(uint64 Hash, FChessAnalysis& OutAnalysis, int32 NewerThanDepth = 0) const;
+
+	/** True while a request is queued or being searched. */
+	bool IsAnalyzing() const;
+
+	/** Empties the result cache now; the search's hash table is cleared before the next search starts. */
+	void ClearCache();
+
+	const FChessAnalysisSettings& GetSettings() const { return Settings; }
+
+private:
+	struct FRequest
+	{
+		FChessPosition Position;
+		TArray<uint64> History;
+	};
+
+	void WorkerLoop();
+	void RunRequest(const FRequest& Request);
+	void Publish(const FChessAnalysis& Analysis);
+
+	const FChessAnalysisSettings Settings;
+
+	/** Only ever searched on the worker thread. */
+	FChessSearch Search;
+
+	/**
+	 * Guards the handoff to the worker. The worker arms the search's stop flag under this lock
+	 * when it takes a request, and callers stop the search under it, so a stop can never land
+	 * between taking a request and starting it and be cleared.
+	 */
+	mutable FCriticalSection RequestLock;
+	TOptional<FRequest> PendingRequest;
+	bool bSearching = false;
+	bool bClearHashPending = false;
+	bool bShutdown = false;
+
+	FEvent* WorkAvailable = nullptr;
+	TFuture<void> WorkerTask;
+
+	mutable FCriticalSection CacheLock;
+	TLruCache<uint64, FChessAnalysis> Cache;
+};
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Same order as EPieceType so the game module can convert with a static_cast.
+enum class EChessPieceType : uint8
+{
+	Pawn,
+	Rook,
+	Knight,
+	Bishop,
+	Queen,
+	King,
+	None
+};
+
+// Same order as ETeam.
+enum class EChessColor : uint8
+{
+	White,
+	Black
+};
+
+FORCEINLINE EChessColor GetOpponent(EChessColor Color)
+{
+	return Color == EChessColor::White ? EChessColor::Black : EChessColor::White;
+}
+
+// Squares are indexed Row * 8 + Col, matching AChessBoardActor::GetIndex.
+// Row 0 is White's back rank, Col 0 is the a-file.
+namespace ChessSquare
+{
+	constexpr int32 None = -1;
+
+	FORCEINLINE constexpr int32 Make(int32 Row, int32 Col) { return Row * 8 + Col; }
+	FORCEINLINE constexpr int32 Row(int32 Square) { return Square >> 3; }
+	FORCEINLINE constexpr int32 Col(int32 Square) { return Square & 7; }
+	FORCEINLINE constexpr bool IsOnBoard(int32 Row, int32 Col) { return Row >= 0 && Row < 8 && Col >= 0 && Col < 8; }
+	FORCEINLINE constexpr bool IsValid(int32 Square) { return Square >= 0 && Square < 64; }
+
+	CHESSCORE_API FString ToString(int32 Square);
+	CHESSCORE_API int32 FromString(const FString& Text);
+}
+
+struct FChessPiece
+{
+	EChessPieceType Type = EChessPieceType::None;
+	EChessColor Color = EChessColor::White;
+
+	FChessPiece() = default;
+	FChessPiece(EChessPieceType InType, EChessColor InColor) : Type(InType), Color(InColor) {}
+
+	FORCEINLINE bool IsEmpty() const { return Type == EChessPieceType::None; }
+	FORCEINLINE bool Is(EChessPieceType InType, EChessColor InColor) const { return Type == InType && Color == InColor; }
+	FORCEINLINE bool operator==(const FChessPiece& Other) const { return Type == Other.Type && (IsEmpty() || Color == Other.Color); }
+	FORCEINLINE bool operator!=(const FChessPiece& Other) const { return !(*this == Other); }
+};
+
+namespace EChessMoveFlags
+{
+	enum Type : uint8
+	{
+		None        = 0,
+		Capture     = 1 << 0,
+		DoublePush  = 1 << 1,
+		EnPassant   = 1 << 2,
+		CastleKing  = 1 << 3,
+		CastleQueen = 1 << 4,
+		Promotion   = 1 << 5,
+	};
+}
+
+namespace EChessCastling
+{
+	enum Type : uint8
+	{
+		None       = 0,
+		WhiteKing  = 1 << 0,
+		WhiteQueen = 1 << 1,
+		BlackKing  = 1 << 2,
+		BlackQueen = 1 << 3,
+		All        = WhiteKing | WhiteQueen | BlackKing | BlackQueen,
+	};
+}
+
+struct CHESSCORE_API FChessMove
+{
+	uint8 From = 0;
+	uint8 To = 0;
+	EChessPieceType Promotion = EChessPieceType::None;
+	uint8 Flags = EChessMoveFlags::None;
+
+	FChessMove() = default;
+	FChessMove(int32 InFrom, int32 InTo, uint8 InFlags = EChessMoveFlags::None, EChessPieceType InPromotion = EChessPieceType::None)
+		: From((uint8)InFrom), To((uint8)InTo), Promotion(InPromotion), Flags(InFlags) {}
+
+	FORCEINLINE bool IsNull() const { return From == To; }
+	FORCEINLINE bool IsCapture() const { return (Flags & (EChessMoveFlags::Capture | EChessMoveFlags::EnPassant)) != 0; }
+	FORCEINLINE bool IsPromotion() const { return Promotion != EChessPieceType::None; }
+	FORCEINLINE bool IsCastle() const { return (Flags & (EChessMoveFlags::CastleKing | EChessMoveFlags::CastleQueen)) != 0; }
+
+	// Flags are derived from the position, so two moves are the same if they share squares and promotion.
+	FORCEINLINE bool operator==(const FChessMove& Other) const { return From == Other.From && To == Other.To && Promotion == Other.Promotion; }
+	FORCEINLINE bool operator!=(const FChessMove& Other) const { return !(*this == Other); }
+
+	// 16-bit packing used by the transposition table.
+	FORCEINLINE uint16 Pack() const { return (uint16)(From | (To << 6) | ((uint8)Promotion << 12)); }
+	static FORCEINLINE FChessMove Unpack(uint16 Packed)
+	{
+		return FChessMove(Packed & 63, (Packed >> 6) & 63, EChessMoveFlags::None, (EChessPieceType)((Packed >> 12) & 7));
+	}
+
+	// Long algebraic notation as used by UCI, e.g. "e2e4" or "e7e8q".
+	FString ToUci() const;
+};
+
+// Worst case is 218 legal moves; keep generation off the heap.
+using FChessMoveList = TArray<FChessMove, TInlineAllocator<256>>;
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ChessCoreTypes.h"
+#include "ChessPosition.h"
+
+enum class EChessGameStatus : uint8
+{
+	InProgress,
+	Checkmate,
+	Stalemate,
+	FiftyMoveRule,
+	Repetition,
+	InsufficientMaterial
+};
+
+/**
+ * A game in progress: the current position, the moves that led to it and the result.
+ * Only legal moves are accepted, so callers can trust the position after every call.
+ * Shared by the game module and the UCI program so both apply the same rules.
+ */
+class CHESSCORE_API FChessMatch
+{
+public:
+	FChessMatch();
+
+	void Reset();
+	bool ResetFromFen(const FString& Fen);
+
+	FORCEINLINE const FChessPosition& GetPosition() const { return Position; }
+	FORCEINLINE EChessColor GetSideToMove() const { return Position.GetSideToMove(); }
+	FORCEINLINE EChessGameStatus GetStatus() const { return Status; }
+	FORCEINLINE bool IsGameOver() const { return Status != EChessGameStatus::InProgress; }
+	FORCEINLINE bool IsInCheck() const { return Position.IsInCheck(Position.GetSideToMove()); }
+	FORCEINLINE int32 GetMoveCount() const { return Records.Num(); }
+	FORCEINLINE const FChessMove& GetLastMove() const { static const FChessMove NoMove; return Records.Num() > 0 ? Records.Last().Move : NoMove; }
+
+	/** Hashes of the positions before the current one, oldest first, as FChessSearch expects. */
+	FORCEINLINE const TArray<uint64>& GetHashHistory() const { return HashHistory; }
+
+	void GetLegalMoves(FChessMoveList& OutMoves) const;
+	void GetLegalMovesFrom(int32 Square, FChessMoveList& OutMoves) const;
+
+	/** Finds the legal move between two squares. Promotions default to a queen. */
+	bool FindLegalMove(int32 From, int32 To, FChessMove& OutMove, EChessPieceType Promotion = EChessPieceType::Queen) const;
+
+	/** Plays a move if it is legal in the current position. */
+	bool MakeMove(const FChessMove& Move);
+
+	/** Takes back the last move. Returns false if there is nothing to undo. */
+	bool UndoMove();
+
+private:
+	void UpdateStatus();
+	bool HasInsufficientMaterial() const;
+
+	struct FRecord
+	{
+		FChessMove Move;
+		FChessPosition::FUndo Undo;
+	};
+
+	FChessPosition Position;
+	TArray<FRecord> Records;
+	TArray<uint64> HashHistory;
+	EChessGameStatus Status = EChessGameStatus::InProgress;
+};
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ChessCoreTypes.h"
+#include "ChessPosition.h"
+
+/**
+ * Move generation for FChessPosition. Pseudo-legal generation leaves the king's safety
+ * to the caller (the search tests it after MakeMove); the legal variants filter it here.
+ */
+struct CHESSCORE_API FChessMoveGenerator
+{
+	static void GeneratePseudoLegal(const FChessPosition& Position, FChessMoveList& OutMoves, bool bCapturesOnly = false);
+
+	static void GenerateLegal(const FChessPosition& Position, FChessMoveList& OutMoves);
+
+	/** Legal moves for the piece on a single square, used for selection highlights. */
+	static void GenerateLegalFrom(const FChessPosition& Position, int32 Square, FChessMoveList& OutMoves);
+
+	/** Finds the legal move matching a UCI string such as "e7e8q". Returns a null move if none. */
+	static FChessMove ParseUciMove(const FChessPosition& Position, const FString& Text);
+
+	static uint64 Perft(FChessPosition& Position, int32 Depth);
+};
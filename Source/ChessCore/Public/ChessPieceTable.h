@@ -0,0 +1,117 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ChessCoreTypes.h"
+#include "ChessPosition.h"
+
+namespace EChessPieceFlags
+{
+	enum Type : uint8
+	{
+		None            = 0,
+		HasMoved        = 1 << 0,
+		JustDoubleMoved = 1 << 1,
+		Captured        = 1 << 2,
+	};
+}
+
+/**
+ * Identity of every piece in a game, stored as parallel arrays indexed by a piece id, plus a
+ * square-to-id map. FChessPosition knows what stands on each square; this table knows which
+ * piece it is, so front ends can bind one actor per id and follow it through moves, castling,
+ * promotion and capture. Captured pieces keep their id with no square.
+ *
+ * Every ApplyMove is recorded, so UndoMove can take it back with ids and flags intact: a piece
+ * keeps its id, and its actor, through any number of moves and takebacks.
+ */
+class CHESSCORE_API FChessPieceTable
+{
+public:
+	static constexpr int32 MaxPieces = 32;
+	static constexpr int8 NoPiece = -1;
+
+	/** Takebacks kept when loading, well past the longest possible game. */
+	static constexpr int32 MaxUndoRecords = 1 << 15;
+
+	/** The ids touched by one move, for callers that only want to update what changed. */
+	struct FMoveEffects
+	{
+		int8 MovedId = NoPiece;
+		int8 CapturedId = NoPiece;
+		int8 RookId = NoPiece;
+		bool bPromoted = false;
+	};
+
+	FChessPieceTable();
+
+	void Reset();
+
+	/**
+	 * Assigns fresh ids to the pieces of Position, a1 to h8, and forgets the move history. Move
+	 * flags are inferred: pawns off their start rank and kings or rooks without castling rights
+	 * count as moved. For new games and loaded positions; takebacks go through UndoMove.
+	 */
+	void SetFromPosition(const FChessPosition& Position);
+
+	/** Updates squares, types and flags for a legal move played from the position this table mirrors. */
+	FMoveEffects ApplyMove(const FChessMove& Move);
+
+	/**
+	 * Reverses the last ApplyMove. The mover, castling rook and captured piece go back to their
+	 * squares under the same ids, a promoted piece becomes a pawn again and every flag is restored.
+	 * Returns the ids touched, or no ids if there is nothing to take back.
+	 */
+	FMoveEffects UndoMove();
+
+	FORCEINLINE bool CanUndo() const { return UndoStack.Num() > 0; }
+
+	FORCEINLINE int32 Num() const { return Count; }
+	FORCEINLINE bool IsValidId(int32 Id) const { return Id >= 0 && Id < Count; }
+
+	FORCEINLINE int8 GetIdAt(int32 Square) const { return ChessSquare::IsValid(Square) ? SquareToId[Square] : NoPiece; }
+	FORCEINLINE int8 GetSquare(int32 Id) const { return Squares[Id]; }
+	FORCEINLINE EChessPieceType GetType(int32 Id) const { return Types[Id]; }
+	FORCEINLINE EChessColor GetColor(int32 Id) const { return Colors[Id]; }
+	FORCEINLINE uint8 GetFlags(int32 Id) const { return Flags[Id]; }
+	FORCEINLINE bool HasFlag(int32 Id, EChessPieceFlags::Type Flag) const { return (Flags[Id] & Flag) != 0; }
+	FORCEINLINE bool IsCaptured(int32 Id) const { return HasFlag(Id, EChessPieceFlags::Captured); }
+
+	/** True if every occupied square of Position maps to a live piece of the same type and color, and nothing else does. */
+	bool IsInSyncWith(const FChessPosition& Position) const;
+
+	friend CHESSCORE_API FArchive& operator<<(FArchive& Ar, FChessPieceTable& Table);
+
+private:
+	/** What one ApplyMove overwrote. */
+	struct FUndoRecord
+	{
+		FChessMove Move;
+		FMoveEffects Effects;
+		uint8 MovedFlags = EChessPieceFlags::None;
+		uint8 CapturedFlags = EChessPieceFlags::None;
+		uint8 RookFlags = EChessPieceFlags::None;
+
+		/** The pawn whose JustDoubleMoved flag the move cleared. */
+		int8 DoubleMovedId = NoPiece;
+	};
+
+	void MovePiece(int32 Id, int32 To);
+	void CapturePiece(int32 Id);
+
+	/** Where the captured piece stands: the target square, or beside it for en passant. */
+	static int32 GetCaptureSquare(const FChessMove& Move);
+
+	/** The castling rook's home square and the square it lands on. */
+	static TPair<int32, int32> GetRookSquares(const FChessMove& Move);
+
+	int32 Count = 0;
+
+	int8 Squares[MaxPieces];
+	EChessPieceType Types[MaxPieces];
+	EChessColor Colors[MaxPieces];
+	uint8 Flags[MaxPieces];
+
+	int8 SquareToId[64];
+
+	TArray<FUndoRecord> UndoStack;
+};
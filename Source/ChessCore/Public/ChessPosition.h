@@ -0,0 +1,80 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ChessCoreTypes.h"
+
+/**
+ * Mailbox board with side to move, castling rights, en passant square, move clocks
+ * and an incrementally updated Zobrist hash. No UObject dependencies.
+ */
+class CHESSCORE_API FChessPosition
+{
+public:
+	static const TCHAR* StartFen;
+
+	/** State needed to take a move back. */
+	struct FUndo
+	{
+		FChessPiece Captured;
+		uint8 CastlingRights = 0;
+		int8 EnPassantSquare = ChessSquare::None;
+		int32 HalfmoveClock = 0;
+		uint64 Hash = 0;
+	};
+
+	FChessPosition();
+
+	void Clear();
+	void SetStartPosition();
+
+	/**
+	 * Returns false and leaves the position untouched if the FEN is malformed, a king is missing,
+	 * a pawn stands on the first or last rank, a castling right has no king and rook at home, or
+	 * the en passant square is not one an enemy pawn has just double-pushed past.
+	 */
+	bool SetFromFen(const FString& Fen);
+	FString ToFen() const;
+
+	FORCEINLINE const FChessPiece& GetPiece(int32 Square) const { return Board[Square]; }
+	FORCEINLINE const FChessPiece& GetPieceAt(int32 Row, int32 Col) const { return Board[ChessSquare::Make(Row, Col)]; }
+	void SetPiece(int32 Square, const FChessPiece& Piece);
+
+	FORCEINLINE EChessColor GetSideToMove() const { return SideToMove; }
+	FORCEINLINE uint8 GetCastlingRights() const { return CastlingRights; }
+	FORCEINLINE int32 GetEnPassantSquare() const { return EnPassantSquare; }
+	FORCEINLINE int32 GetHalfmoveClock() const { return HalfmoveClock; }
+	FORCEINLINE int32 GetFullmoveNumber() const { return FullmoveNumber; }
+	FORCEINLINE uint64 GetHash() const { return Hash; }
+	FORCEINLINE int32 GetKingSquare(EChessColor Color) const { return KingSquare[(uint8)Color]; }
+
+	bool IsSquareAttacked(int32 Square, EChessColor ByColor) const;
+	FORCEINLINE bool IsInCheck(EChessColor Color) const
+	{
+		const int32 King = GetKingSquare(Color);
+		return King != ChessSquare::None && IsSquareAttacked(King, GetOpponent(Color));
+	}
+
+	/** Applies a move produced by FChessMoveGenerator. The move must be at least pseudo-legal. */
+	void MakeMove(const FChessMove& Move, FUndo& OutUndo);
+	void UnmakeMove(const FChessMove& Move, const FUndo& Undo);
+
+	void MakeNullMove(FUndo& OutUndo);
+	void UnmakeNullMove(const FUndo& Undo);
+
+	/** Full recomputation, used after setup and to verify the incremental hash. */
+	uint64 ComputeHash() const;
+
+private:
+	void PlacePiece(int32 Square, const FChessPiece& Piece);
+	void RemovePiece(int32 Square);
+	void SetEnPassantSquare(int32 Square);
+
+	FChessPiece Board[64];
+	int32 KingSquare[2];
+	EChessColor SideToMove;
+	uint8 CastlingRights;
+	int32 EnPassantSquare;
+	int32 HalfmoveClock;
+	int32 FullmoveNumber;
+	uint64 Hash;
+};
@@ -0,0 +1,164 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ChessCoreTypes.h"
+#include "ChessPosition.h"
+#include <atomic>
+
+struct FChessSearchLimits
+{
+	/** Maximum iterative-deepening depth. 0 means no depth limit. */
+	int32 Depth = 0;
+
+	/** Wall-clock budget in milliseconds. 0 means no time limit. */
+	int32 MoveTimeMs = 0;
+
+	/** Node budget for the main thread. 0 means no node limit. */
+	uint64 Nodes = 0;
+
+	/** Keep searching until Stop() is called, even after the depth cap is reached. */
+	bool bInfinite = false;
+
+	/** Number of best root moves to search to full depth, each with its own line. */
+	int32 MultiPV = 1;
+};
+
+/** One root move and the line that follows it. Score is from the side to move's point of view. */
+struct FChessSearchLine
+{
+	int32 Score = 0;
+	TArray<FChessMove> PrincipalVariation;
+};
+
+/** Progress report sent after every completed line of every iteration of the main thread. */
+struct FChessSearchInfo
+{
+	/** 1 for the best line, 2 for the second best and so on. */
+	int32 MultiPVIndex = 1;
+	int32 Depth = 0;
+	int32 SelDepth = 0;
+	int32 Score = 0;
+	uint64 Nodes = 0;
+	double ElapsedSeconds = 0.0;
+	uint64 TTProbes = 0;
+	uint64 TTHits = 0;
+	int32 HashFullPermill = 0;
+	TArray<FChessMove> PrincipalVariation;
+};
+
+struct FChessSearchResult
+{
+	FChessMove BestMove;
+	FChessMove PonderMove;
+	int32 Score = 0;
+	int32 Depth = 0;
+	uint64 Nodes = 0;
+	double ElapsedSeconds = 0.0;
+
+	/** The lines of the last completed iteration, best first. Holds MultiPV entries when there are enough legal moves. */
+	TArray<FChessSearchLine> Lines;
+};
+
+/**
+ * Shared hash table of search results. Entries are written without locks; each slot
+ * stores its key XOR'd with its payload so torn writes from helper threads are rejected.
+ */
+class CHESSCORE_API FChessTranspositionTable
+{
+public:
+	enum class EBound : uint8
+	{
+		None,
+		Exact,
+		Lower,
+		Upper
+	};
+
+	struct FProbe
+	{
+		FChessMove Move;
+		int32 Score = 0;
+		int32 Depth = 0;
+		EBound Bound = EBound::None;
+	};
+
+	FChessTranspositionTable();
+
+	void Resize(int32 SizeMB);
+	void Clear();
+	void NewSearch() { ++Generation; }
+
+	bool Probe(uint64 Key, FProbe& OutProbe) const;
+	void Store(uint64 Key, const FChessMove& Move, int32 Score, int32 Depth, EBound Bound);
+
+	/** Per-mill occupancy by the current search, as reported by UCI "hashfull". */
+	int32 GetHashFullPermill() const;
+
+private:
+	struct FEntry
+	{
+		std::atomic<uint64> KeyXorData{ 0 };
+		std::atomic<uint64> Data{ 0 };
+	};
+
+	TUniquePtr<FEntry[]> Entries;
+	uint64 EntryCount = 0;
+	uint8 Generation = 0;
+};
+
+/**
+ * Iterative-deepening alpha-beta search over FChessPosition. Runs on the calling thread;
+ * with more than one thread configured, helper threads share the transposition table
+ * and search the same root (lazy SMP). Stop() may be called from any thread.
+ *
+ * Search() never clears a pending stop. Call BeginSearch() on the thread that launches the
+ * search, before launching it, so a Stop() issued while the worker is still starting up
+ * ends that search instead of being lost.
+ */
+class CHESSCORE_API FChessSearch
+{
+public:
+	static constexpr int32 MaxPly = 128;
+	static constexpr int32 MateScore = 32000;
+	static constexpr int32 MateThreshold = MateScore - MaxPly;
+	static constexpr int32 InfiniteScore = 32500;
+
+	using FOnInfo = TFunction<void(const FChessSearchInfo&)>;
+
+	FChessSearch();
+	~FChessSearch();
+
+	void SetHashSizeMB(int32 SizeMB);
+	void SetThreadCount(int32 Count);
+	int32 GetThreadCount() const { return ThreadCount; }
+	void ClearHash();
+
+	/** Arms the stop flag for the next Search(). Must happen before that search is started. */
+	void BeginSearch() { bStopRequested.store(false, std::memory_order_relaxed); }
+
+	/**
+	 * Searches Root under Limits. History holds the hashes of earlier positions in the game,
+	 * oldest first, so repetitions are scored as draws. Returns at once if stopped since the
+	 * last BeginSearch(); the stop flag is left set when it returns.
+	 */
+	FChessSearchResult Search(const FChessPosition& Root, const TArray<uint64>& History, const FChessSearchLimits& Limits, const FOnInfo& OnInfo = FOnInfo());
+
+	void Stop() { bStopRequested.store(true, std::memory_order_relaxed); }
+	bool IsStopRequested() const { return bStopRequested.load(std::memory_order_relaxed); }
+
+	/** Static evaluation in centipawns from the side to move's point of view. */
+	static int32 Evaluate(const FChessPosition& Position);
+
+	static bool IsMateScore(int32 Score) { return FMath::Abs(Score) >= MateThreshold; }
+
+	/** Moves to mate, positive if the side to move mates. Only meaningful for mate scores. */
+	static int32 MateInMoves(int32 Score) { return Score > 0 ? (MateScore - Score + 1) / 2 : -(MateScore + Score) / 2; }
+
+private:
+	struct FWorker;
+	friend struct FWorker;
+
+	FChessTranspositionTable TranspositionTable;
+	int32 ThreadCount = 1;
+	std::atomic<bool> bStopRequested{ false };
+};
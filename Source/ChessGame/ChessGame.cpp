@@ -4,3 +4,17 @@
 #include "Modules/ModuleManager.h"
 
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, ChessGame, "ChessGame" );
+
+DEFINE_STAT(STAT_ChessPicking);
+DEFINE_STAT(STAT_ChessCalculatePossibleMoves);
+DEFINE_STAT(STAT_ChessShowHighlights);
+DEFINE_STAT(STAT_ChessMoveSelectedPiece);
+DEFINE_STAT(STAT_ChessApplyMove);
+DEFINE_STAT(STAT_ChessSpawnBoard);
+DEFINE_STAT(STAT_ChessSpawnPieces);
+DEFINE_STAT(STAT_ChessShowAnalysis);
+DEFINE_STAT(STAT_ChessMovesGenerated);
+DEFINE_STAT(STAT_ChessActorSpawns);
+DEFINE_STAT(STAT_ChessActorDestroys);
+DEFINE_STAT(STAT_ChessPiecesReused);
+DEFINE_STAT(STAT_ChessHighlightComponents);
@@ -3,4 +3,25 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
 
+// "stat chess" in the console. Cycle stats also show up as timers in Unreal Insights.
+DECLARE_STATS_GROUP(TEXT("Chess"), STATGROUP_Chess, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Picking"), STAT_ChessPicking, STATGROUP_Chess, CHESSGAME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Calculate Possible Moves"), STAT_ChessCalculatePossibleMoves, STATGROUP_Chess, CHESSGAME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Show Highlights"), STAT_ChessShowHighlights, STATGROUP_Chess, CHESSGAME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Move Selected Piece"), STAT_ChessMoveSelectedPiece, STATGROUP_Chess, CHESSGAME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Apply Move"), STAT_ChessApplyMove, STATGROUP_Chess, CHESSGAME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Spawn Board"), STAT_ChessSpawnBoard, STATGROUP_Chess, CHESSGAME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Spawn Pieces"), STAT_ChessSpawnPieces, STATGROUP_Chess, CHESSGAME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Show Analysis"), STAT_ChessShowAnalysis, STATGROUP_Chess, CHESSGAME_API);
+
+// Per-frame counters; a move is applied within a single frame, so these read as per-move.
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Moves Generated"), STAT_ChessMovesGenerated, STATGROUP_Chess, CHESSGAME_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Actor Spawns"), STAT_ChessActorSpawns, STATGROUP_Chess, CHESSGAME_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Actor Destroys"), STAT_ChessActorDestroys, STATGROUP_Chess, CHESSGAME_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Pieces Reused"), STAT_ChessPiecesReused, STATGROUP_Chess, CHESSGAME_API);
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Highlight Components"), STAT_ChessHighlightComponents, STATGROUP_Chess, CHESSGAME_API);
@@ -1,6 +1,10 @@
 ﻿#include "ChessBoardActor.h"
+#include "ChessGame.h"
 #include "Components/StaticMeshComponent.h"
 #include "Engine/World.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "Materials/MaterialInterface.h"
 
 AChessBoardActor::AChessBoardActor()
 {
@@ -21,18 +25,57 @@ void AChessBoardActor::BeginPlay()
 {
 	Super::BeginPlay();
 
+	// Boards spawned from a template inherit its references; start from a clean grid.
+	SpawnedTiles.Reset();
+	HighlightTiles.Reset();
+	PiecePool.Reset();
+	FreePieces.Reset();
+	PieceActors.Reset();
+
 	SpawnBoard();
-	BoardGrid.SetNum(64);
+	LoadPieceSet();
 	SpawnPieces();
 }
 
+void AChessBoardActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Pieces are separate actors; take them with the board so a removed board leaves nothing behind.
+	for (AChessPieces* Piece : PiecePool)
+	{
+		if (!IsValid(Piece)) continue;
+		Piece->Destroy();
+		INC_DWORD_STAT(STAT_ChessActorDestroys);
+	}
+	PiecePool.Empty();
+	FreePieces.Empty();
+	PieceActors.Empty();
+
+	if (PieceSetHandle.IsValid())
+	{
+		PieceSetHandle->CancelHandle();
+		PieceSetHandle.Reset();
+	}
+
+	AnalysisService.Reset();
+
+	// Keeps the shared highlight counter right when a board goes away mid-selection.
+	ClearHighlights();
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void AChessBoardActor::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
+
+	UpdateAnalysisOverlay();
 }
 
 void AChessBoardActor::SpawnBoard()
 {
+	SCOPE_CYCLE_COUNTER(STAT_ChessSpawnBoard);
+	TRACE_CPUPROFILER_EVENT_SCOPE(AChessBoardActor::SpawnBoard);
+
 	if (!BlackTileMesh || !WhiteTileMesh)
 	{
 		UE_LOG(LogTemp, Warning, TEXT("Tile Meshes are not set!"));
@@ -77,52 +120,273 @@ void AChessBoardActor::SpawnBoard()
 
 void AChessBoardActor::SpawnPieces()
 {
-	auto SpawnPiece = [&](UStaticMesh* Mesh, int Row, int Col, EPieceType Type, ETeam Team)
+	SCOPE_CYCLE_COUNTER(STAT_ChessSpawnPieces);
+	TRACE_CPUPROFILER_EVENT_SCOPE(AChessBoardActor::SpawnPieces);
+
+	Match.Reset();
+	SyncPiecesToMatch();
+	RequestAnalysis();
+}
+
+void AChessBoardActor::SyncPiecesToMatch()
+{
+	// Everything goes back to the pool first, so a new game reuses the same actors.
+	for (AChessPieces* Piece : PieceActors)
+		ReleasePiece(Piece);
+
+	Pieces.SetFromPosition(Match.GetPosition());
+	PieceActors.Init(nullptr, Pieces.Num());
+
+	for (int32 Id = 0; Id < Pieces.Num(); ++Id)
+		AcquirePiece(Id);
+}
+
+void AChessBoardActor::ResetGame()
+{
+	ClearHighlights();
+	SpawnPieces();
+}
+
+bool AChessBoardActor::UndoMove()
+{
+	if (!Match.UndoMove()) return false;
+
+	ClearHighlights();
+
+	// The table reverses the move itself, so every piece keeps its id, flags and actor.
+	if (Pieces.CanUndo())
+	{
+		const FChessPieceTable::FMoveEffects Effects = Pieces.UndoMove();
+		checkSlow(Pieces.IsInSyncWith(Match.GetPosition()));
+
+		// Captures come back in the reverse order they went, so the pool hands back the same actor.
+		if (Pieces.IsValidId(Effects.CapturedId))
+			AcquirePiece(Effects.CapturedId);
+
+		if (Effects.bPromoted && PieceActors.IsValidIndex(Effects.MovedId))
+			ApplyPieceVisuals(PieceActors[Effects.MovedId]);
+
+		PlacePieceActor(Effects.MovedId);
+		PlacePieceActor(Effects.RookId);
+	}
+	else
+	{
+		SyncPiecesToMatch();
+	}
+
+	RequestAnalysis();
+	return true;
+}
+
+AChessPieces* AChessBoardActor::AcquirePiece(int32 Id)
+{
+	if (!ChessPieceClass) return nullptr;
+
+	AChessPieces* Piece = nullptr;
+	while (!Piece && FreePieces.Num() > 0)
+	{
+		Piece = FreePieces.Pop(EAllowShrinking::No);
+		if (!IsValid(Piece)) Piece = nullptr;
+	}
+
+	if (Piece)
+	{
+		INC_DWORD_STAT(STAT_ChessPiecesReused);
+		Piece->SetActorHiddenInGame(false);
+		Piece->SetActorEnableCollision(true);
+		Piece->SetActorTickEnabled(true);
+	}
+	else
+	{
+		FActorSpawnParameters SpawnParams;
+		Piece = GetWorld()->SpawnActor<AChessPieces>(ChessPieceClass, FTransform::Identity, SpawnParams);
+		if (!Piece) return nullptr;
+
+		INC_DWORD_STAT(STAT_ChessActorSpawns);
+		PiecePool.Add(Piece);
+	}
+
+	Piece->BindToBoard(this, Id);
+	Piece->SetActorRotation(FRotator::ZeroRotator);
+	ApplyPieceVisuals(Piece);
+	PieceActors[Id] = Piece;
+	PlacePieceActor(Id, -0.1f);
+	return Piece;
+}
+
+void AChessBoardActor::PlacePieceActor(int32 Id, float ZFactor)
+{
+	AChessPieces* Piece = PieceActors.IsValidIndex(Id) ? PieceActors[Id] : nullptr;
+	if (!Piece || Pieces.IsCaptured(Id)) return;
+
+	const int32 Square = Pieces.GetSquare(Id);
+	float PieceZ = GetSafeZOffset(Piece->PieceMesh ? Piece->PieceMesh->GetStaticMesh() : nullptr, ZFactor) * Piece->GetActorScale3D().Z;
+	Piece->SetActorLocation(GetTileWorldPosition(ChessSquare::Row(Square), ChessSquare::Col(Square)) + FVector(0, 0, PieceZ));
+}
+
+void AChessBoardActor::ReleasePiece(AChessPieces* Piece)
+{
+	if (!IsValid(Piece)) return;
+
+	// Hidden and without collision, an idle piece cannot be seen or picked.
+	Piece->SetActorHiddenInGame(true);
+	Piece->SetActorEnableCollision(false);
+	Piece->SetActorTickEnabled(false);
+	Piece->BindToBoard(nullptr, INDEX_NONE);
+	FreePieces.AddUnique(Piece);
+}
+
+UStaticMesh* AChessBoardActor::GetPieceMesh(EPieceType Type, ETeam Team) const
+{
+	if (!PieceSet || !ShouldLoadPieceMeshes()) return nullptr;
+
+	const TSoftObjectPtr<UStaticMesh>& Mesh = PieceSet->GetMesh(Type, Team);
+	if (UStaticMesh* Loaded = Mesh.Get())
+		return Loaded;
+
+	// Still streaming in; OnPieceSetLoaded swaps the real mesh in when it arrives.
+	return PlaceholderMesh;
+}
+
+bool AChessBoardActor::ShouldLoadPieceMeshes() const
+{
+	// Servers only need the rules; piece meshes and their textures never leave disk.
+	return GetNetMode() != NM_DedicatedServer;
+}
+
+void AChessBoardActor::SetPieceSet(UChessPieceSet* NewSet)
+{
+	if (NewSet == PieceSet) return;
+
+	PieceSet = NewSet;
+	LoadPieceSet();
+}
+
+bool AChessBoardActor::IsPieceSetLoaded() const
+{
+	return PieceSetHandle.IsValid() && PieceSetHandle->HasLoadCompleted();
+}
+
+void AChessBoardActor::LoadPieceSet()
+{
+	if (PieceSetHandle.IsValid())
+	{
+		PieceSetHandle->CancelHandle();
+		PieceSetHandle.Reset();
+	}
+
+	if (!PieceSet)
+	{
+		UE_LOG(LogTemp, Log, TEXT("No piece set on %s, using the default set"), *GetName());
+		PieceSet = GetMutableDefault<UChessPieceSet>();
+	}
+
+	if (!ShouldLoadPieceMeshes()) return;
+
+	// The placeholder is tiny; load it now so pieces are visible from the first frame. An invisible
+	// piece has no collision and cannot be picked, so a set without one borrows the engine cylinder.
+	PlaceholderMesh = PieceSet->PlaceholderMesh.LoadSynchronous();
+	if (!PlaceholderMesh)
+	{
+		static bool bWarned = false;
+		if (!bWarned)
 		{
-			if (!Mesh || !ChessPieceClass) return;
+			UE_LOG(LogTemp, Warning, TEXT("Piece set %s has no usable placeholder mesh, using the engine cylinder"), *PieceSet->GetName());
+			bWarned = true;
+		}
+		PlaceholderMesh = UChessPieceSet::GetDefaultPlaceholderMesh().LoadSynchronous();
+	}
 
-			float pieceZ = GetSafeZOffset(Mesh, -0.1f);
+	TArray<FSoftObjectPath> Paths;
+	PieceSet->GetAssetsToLoad(Paths);
+	if (Paths.Num() == 0) return;
 
-			FVector SpawnLocation = GetTileWorldPosition(Row, Col) + FVector(0, 0, pieceZ);
-			FRotator SpawnRotation = FRotator::ZeroRotator;
-			FActorSpawnParameters SpawnParams;
+	PieceSetHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(Paths,
+		FStreamableDelegate::CreateUObject(this, &AChessBoardActor::OnPieceSetLoaded));
+}
 
-			AChessPieces* Piece = GetWorld()->SpawnActor<AChessPieces>(ChessPieceClass, SpawnLocation, SpawnRotation, SpawnParams);
-			if (Piece)
-			{
-				Piece->PieceType = Type;
-				Piece->Team = Team;
-				Piece->BoardRow = Row;
-				Piece->BoardCol = Col;
+void AChessBoardActor::OnPieceSetLoaded()
+{
+	// Idle pool pieces pick up the new set when they are next acquired.
+	for (int32 Id = 0; Id < PieceActors.Num(); ++Id)
+	{
+		ApplyPieceVisuals(PieceActors[Id]);
 
-				if (Piece->PieceMesh)
-					Piece->PieceMesh->SetStaticMesh(Mesh);
+		// The real meshes can sit at a different height from the placeholder.
+		PlacePieceActor(Id);
+	}
+}
+
+void AChessBoardActor::ApplyPieceVisuals(AChessPieces* Piece) const
+{
+	if (!Piece || !Piece->PieceMesh) return;
+
+	UStaticMesh* Mesh = GetPieceMesh(Piece->GetPieceType(), Piece->GetTeam());
+	Piece->PieceMesh->SetStaticMesh(Mesh);
+
+	// The placeholder is a generic shape of arbitrary size; shrink it to half a tile wide.
+	// Real meshes go back to whatever scale the piece class was authored with.
+	const AChessPieces* Defaults = Piece->GetClass()->GetDefaultObject<AChessPieces>();
+	FVector Scale = Defaults->PieceMesh ? Defaults->PieceMesh->GetRelativeScale3D() : FVector::OneVector;
+	if (Mesh && Mesh == PlaceholderMesh && TileSizeX > 0.f)
+	{
+		const FVector Extent = Mesh->GetBounds().BoxExtent;
+		const float Width = 2.f * FMath::Max(Extent.X, Extent.Y);
+		if (Width > 0.f)
+			Scale = FVector(0.5f * TileSizeX / Width);
+	}
+	Piece->SetActorScale3D(Scale);
+
+	// Team materials only go on the real meshes; the placeholder keeps its own cheap material.
+	Piece->PieceMesh->EmptyOverrideMaterials();
+	UMaterialInterface* Material = PieceSet ? PieceSet->GetMaterial(Piece->GetTeam()).Get() : nullptr;
+	if (Material && Mesh && Mesh != PlaceholderMesh)
+		for (int32 Index = 0; Index < Piece->PieceMesh->GetNumMaterials(); ++Index)
+			Piece->PieceMesh->SetMaterial(Index, Material);
+}
 
-				SetPieceAt(Row, Col, Piece);
-			}
-		};
+void AChessBoardActor::GetLegalMoves(int32 Row, int32 Col, TArray<FVector2D>& OutMoves) const
+{
+	OutMoves.Empty();
 
-	for (int Col = 0; Col < 8; ++Col)
+	FChessMoveList Moves;
+	Match.GetLegalMovesFrom(GetIndex(Row, Col), Moves);
+	INC_DWORD_STAT_BY(STAT_ChessMovesGenerated, Moves.Num());
+	for (const FChessMove& Move : Moves)
 	{
-		SpawnPiece(WhitePawn, 1, Col, EPieceType::Pawn, ETeam::White);
-		SpawnPiece(BlackPawn, 6, Col, EPieceType::Pawn, ETeam::Black);
+		// Promotions produce one move per piece; the board only needs each square once.
+		const FVector2D Target(ChessSquare::Row(Move.To), ChessSquare::Col(Move.To));
+		OutMoves.AddUnique(Target);
 	}
+}
+
+bool AChessBoardActor::ApplyMove(int32 FromRow, int32 FromCol, int32 ToRow, int32 ToCol)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ChessApplyMove);
+	TRACE_CPUPROFILER_EVENT_SCOPE(AChessBoardActor::ApplyMove);
 
-	UStaticMesh* WhitePieces[8] = { WhiteRook, WhiteKnight, WhiteBishop, WhiteQueen,
-									WhiteKing, WhiteBishop, WhiteKnight, WhiteRook };
-	UStaticMesh* BlackPieces[8] = { BlackRook, BlackKnight, BlackBishop, BlackQueen,
-									BlackKing, BlackBishop, BlackKnight, BlackRook };
+	FChessMove Move;
+	if (!Match.FindLegalMove(GetIndex(FromRow, FromCol), GetIndex(ToRow, ToCol), Move) || !Match.MakeMove(Move))
+		return false;
 
-	EPieceType WhitePieceTypes[8] = { EPieceType::Rook, EPieceType::Knight, EPieceType::Bishop, EPieceType::Queen,
-									  EPieceType::King, EPieceType::Bishop, EPieceType::Knight, EPieceType::Rook };
-	EPieceType BlackPieceTypes[8] = { EPieceType::Rook, EPieceType::Knight, EPieceType::Bishop, EPieceType::Queen,
-									  EPieceType::King, EPieceType::Bishop, EPieceType::Knight, EPieceType::Rook };
+	// The table resolves en passant, castling and promotion; the actors just follow it.
+	const FChessPieceTable::FMoveEffects Effects = Pieces.ApplyMove(Move);
+	checkSlow(Pieces.IsInSyncWith(Match.GetPosition()));
 
-	for (int Col = 0; Col < 8; ++Col)
+	if (PieceActors.IsValidIndex(Effects.CapturedId))
 	{
-		SpawnPiece(WhitePieces[Col], 0, Col, WhitePieceTypes[Col], ETeam::White);
-		SpawnPiece(BlackPieces[Col], 7, Col, BlackPieceTypes[Col], ETeam::Black);
+		ReleasePiece(PieceActors[Effects.CapturedId]);
+		PieceActors[Effects.CapturedId] = nullptr;
 	}
+
+	if (Effects.bPromoted && PieceActors.IsValidIndex(Effects.MovedId))
+		ApplyPieceVisuals(PieceActors[Effects.MovedId]);
+
+	PlacePieceActor(Effects.MovedId);
+	PlacePieceActor(Effects.RookId);
+
+	RequestAnalysis();
+	return true;
 }
 
 FVector AChessBoardActor::GetTileWorldPosition(int32 Row, int32 Col) const
@@ -157,9 +421,10 @@ FVector2D AChessBoardActor::ConvertWorldToBoardPosition(const FVector& WorldPosi
 
 void AChessBoardActor::ShowHighlights(const TArray<FVector2D>& Moves)
 {
-	for (UStaticMeshComponent* Tile : HighlightTiles)
-		if (Tile) Tile->DestroyComponent();
-	HighlightTiles.Empty();
+	SCOPE_CYCLE_COUNTER(STAT_ChessShowHighlights);
+	TRACE_CPUPROFILER_EVENT_SCOPE(AChessBoardActor::ShowHighlights);
+
+	ClearHighlights();
 
 	if (!HighlightMesh) return;
 
@@ -180,13 +445,127 @@ void AChessBoardActor::ShowHighlights(const TArray<FVector2D>& Moves)
 
 		HighlightTiles.Add(Highlight);
 	}
+
+	// Every board adds to the same counter, so it tracks live components across all of them.
+	INC_DWORD_STAT_BY(STAT_ChessHighlightComponents, HighlightTiles.Num());
 }
 
 void AChessBoardActor::ClearHighlights()
 {
 	for (UStaticMeshComponent* Tile : HighlightTiles)
 		if (Tile) Tile->DestroyComponent();
+
+	DEC_DWORD_STAT_BY(STAT_ChessHighlightComponents, HighlightTiles.Num());
 	HighlightTiles.Empty();
 }
 
+void AChessBoardActor::SetAnalysisEnabled(bool bEnabled)
+{
+	bShowAnalysis = bEnabled;
+	if (!bShowAnalysis)
+		AnalysisService.Reset();
+	RequestAnalysis();
+}
+
+bool AChessBoardActor::GetEvaluation(int32& OutCentipawns, int32& OutDepth) const
+{
+	if (!ShownAnalysis.IsValid()) return false;
+
+	OutCentipawns = ShownAnalysis.GetWhiteScore();
+	OutDepth = ShownAnalysis.Depth;
+	return true;
+}
+
+void AChessBoardActor::RequestAnalysis()
+{
+	ClearAnalysis();
+
+	// Servers never display the overlay, so they never pay for the search.
+	if (!bShowAnalysis || GetNetMode() == NM_DedicatedServer)
+		return;
+
+	if (!AnalysisService)
+	{
+		FChessAnalysisSettings Settings;
+		Settings.MultiPV = AnalysisLines;
+		Settings.MaxDepth = AnalysisDepth;
+		AnalysisService = MakeUnique<FChessAnalysisService>(Settings);
+	}
+
+	if (Match.IsGameOver())
+	{
+		AnalysisService->Stop();
+		return;
+	}
+
+	AnalysisService->Analyze(Match.GetPosition(), Match.GetHashHistory());
+
+	// A position seen before is already in the cache; show it without waiting a frame.
+	UpdateAnalysisOverlay();
+}
+
+void AChessBoardActor::UpdateAnalysisOverlay()
+{
+	if (!AnalysisService) return;
+
+	const uint64 Hash = Match.GetPosition().GetHash();
+	const int32 ShownDepth = ShownAnalysis.Hash == Hash ? ShownAnalysis.Depth : 0;
+
+	FChessAnalysis Analysis;
+	if (AnalysisService->GetAnalysis(Hash, Analysis, ShownDepth))
+		ShowAnalysis(Analysis);
+}
+
+void AChessBoardActor::ShowAnalysis(const FChessAnalysis& Analysis)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ChessShowAnalysis);
+	TRACE_CPUPROFILER_EVENT_SCOPE(AChessBoardActor::ShowAnalysis);
+
+	ShownAnalysis = Analysis;
+	if (!AnalysisMarkerMesh) return;
+
+	// Each line marks its move's from and to squares; markers are reused as the search deepens.
+	const int32 NumMarkers = Analysis.Lines.Num() * 2;
+	while (AnalysisMarkers.Num() < NumMarkers)
+	{
+		UStaticMeshComponent* Marker = NewObject<UStaticMeshComponent>(this);
+		Marker->SetStaticMesh(AnalysisMarkerMesh);
+		Marker->SetMobility(EComponentMobility::Movable);
+		Marker->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		Marker->AttachToComponent(ChessBoardComponent, FAttachmentTransformRules::KeepRelativeTransform);
+		Marker->RegisterComponent();
+
+		AnalysisMarkers.Add(Marker);
+	}
 
+	const float MarkerZ = GetSafeZOffset(AnalysisMarkerMesh, 0.15f);
+	for (int32 Index = 0; Index < AnalysisMarkers.Num(); ++Index)
+	{
+		UStaticMeshComponent* Marker = AnalysisMarkers[Index];
+		if (!Marker) continue;
+
+		const int32 LineIndex = Index / 2;
+		if (LineIndex >= Analysis.Lines.Num() || Analysis.Lines[LineIndex].PrincipalVariation.Num() == 0)
+		{
+			Marker->SetVisibility(false);
+			continue;
+		}
+
+		// The best move gets the largest marker.
+		const FChessMove& Move = Analysis.Lines[LineIndex].PrincipalVariation[0];
+		const int32 Square = (Index % 2 == 0) ? Move.From : Move.To;
+		const float Scale = FMath::Max(0.4f, 1.f - 0.25f * LineIndex);
+
+		Marker->SetWorldLocation(GetTileWorldPosition(ChessSquare::Row(Square), ChessSquare::Col(Square)) + FVector(0, 0, MarkerZ));
+		Marker->SetRelativeScale3D(FVector(Scale));
+		Marker->SetVisibility(true);
+	}
+}
+
+void AChessBoardActor::ClearAnalysis()
+{
+	ShownAnalysis = FChessAnalysis();
+
+	for (UStaticMeshComponent* Marker : AnalysisMarkers)
+		if (Marker) Marker->SetVisibility(false);
+}
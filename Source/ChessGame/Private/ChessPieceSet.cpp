@@ -0,0 +1,71 @@
+#include "ChessPieceSet.h"
+#include "Engine/StaticMesh.h"
+#include "Materials/MaterialInterface.h"
+
+namespace
+{
+	TSoftObjectPtr<UStaticMesh> ShippedPieceMesh(const TCHAR* Team, const TCHAR* Piece)
+	{
+		return TSoftObjectPtr<UStaticMesh>(FSoftObjectPath(FString::Printf(
+			TEXT("/Game/Assets/Models/ChessPieces/%sPieces/Models/%s%s.%s%s"), Team, Team, Piece, Team, Piece)));
+	}
+}
+
+UChessPieceSet::UChessPieceSet()
+{
+	PlaceholderMesh = GetDefaultPlaceholderMesh();
+
+	WhitePawn = ShippedPieceMesh(TEXT("White"), TEXT("Pawn"));
+	WhiteRook = ShippedPieceMesh(TEXT("White"), TEXT("Rook"));
+	WhiteKnight = ShippedPieceMesh(TEXT("White"), TEXT("Knight"));
+	WhiteBishop = ShippedPieceMesh(TEXT("White"), TEXT("Bishop"));
+	WhiteQueen = ShippedPieceMesh(TEXT("White"), TEXT("Queen"));
+	WhiteKing = ShippedPieceMesh(TEXT("White"), TEXT("King"));
+
+	BlackPawn = ShippedPieceMesh(TEXT("Black"), TEXT("Pawn"));
+	BlackRook = ShippedPieceMesh(TEXT("Black"), TEXT("Rook"));
+	BlackKnight = ShippedPieceMesh(TEXT("Black"), TEXT("Knight"));
+	BlackBishop = ShippedPieceMesh(TEXT("Black"), TEXT("Bishop"));
+	BlackQueen = ShippedPieceMesh(TEXT("Black"), TEXT("Queen"));
+	BlackKing = ShippedPieceMesh(TEXT("Black"), TEXT("King"));
+}
+
+const TSoftObjectPtr<UStaticMesh>& UChessPieceSet::GetMesh(EPieceType Type, ETeam Team) const
+{
+	const bool bWhite = Team == ETeam::White;
+	switch (Type)
+	{
+	case EPieceType::Pawn:   return bWhite ? WhitePawn : BlackPawn;
+	case EPieceType::Rook:   return bWhite ? WhiteRook : BlackRook;
+	case EPieceType::Knight: return bWhite ? WhiteKnight : BlackKnight;
+	case EPieceType::Bishop: return bWhite ? WhiteBishop : BlackBishop;
+	case EPieceType::Queen:  return bWhite ? WhiteQueen : BlackQueen;
+	case EPieceType::King:   return bWhite ? WhiteKing : BlackKing;
+	}
+	return PlaceholderMesh;
+}
+
+TSoftObjectPtr<UStaticMesh> UChessPieceSet::GetDefaultPlaceholderMesh()
+{
+	// Engine content, so it is always there and tiny.
+	return TSoftObjectPtr<UStaticMesh>(FSoftObjectPath(TEXT("/Engine/BasicShapes/Cylinder.Cylinder")));
+}
+
+const TSoftObjectPtr<UMaterialInterface>& UChessPieceSet::GetMaterial(ETeam Team) const
+{
+	return Team == ETeam::White ? WhiteMaterial : BlackMaterial;
+}
+
+void UChessPieceSet::GetAssetsToLoad(TArray<FSoftObjectPath>& OutPaths) const
+{
+	const TSoftObjectPtr<UStaticMesh>* Meshes[] =
+	{
+		&WhitePawn, &WhiteRook, &WhiteKnight, &WhiteBishop, &WhiteQueen, &WhiteKing,
+		&BlackPawn, &BlackRook, &BlackKnight, &BlackBishop, &BlackQueen, &BlackKing,
+	};
+	for (const TSoftObjectPtr<UStaticMesh>* Mesh : Meshes)
+		if (!Mesh->IsNull()) OutPaths.AddUnique(Mesh->ToSoftObjectPath());
+
+	if (!WhiteMaterial.IsNull()) OutPaths.AddUnique(WhiteMaterial.ToSoftObjectPath());
+	if (!BlackMaterial.IsNull()) OutPaths.AddUnique(BlackMaterial.ToSoftObjectPath());
+}
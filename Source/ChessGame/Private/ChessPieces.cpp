@@ -1,4 +1,5 @@
 #include "ChessPieces.h"
+#include "ChessBoardActor.h"
 
 AChessPieces::AChessPieces()
 {
@@ -21,10 +22,50 @@ void AChessPieces::Tick(float DeltaTime)
 	Super::Tick(DeltaTime);
 }
 
-void AChessPieces::InitalizePiece(EPieceType InType, ETeam InTeam, UStaticMesh* InMesh)
+void AChessPieces::BindToBoard(AChessBoardActor* InBoard, int32 InPieceId)
 {
-	PieceType = InType;
-	Team = InTeam;
-	if (InMesh)
-		PieceMesh->SetStaticMesh(InMesh);
+	Board = InBoard;
+	PieceId = InPieceId;
+}
+
+const FChessPieceTable* AChessPieces::GetTable() const
+{
+	if (!Board || !Board->GetPieceTable().IsValidId(PieceId)) return nullptr;
+	return &Board->GetPieceTable();
+}
+
+EPieceType AChessPieces::GetPieceType() const
+{
+	const FChessPieceTable* Table = GetTable();
+	return Table ? ToPieceType(Table->GetType(PieceId)) : EPieceType::Pawn;
+}
+
+ETeam AChessPieces::GetTeam() const
+{
+	const FChessPieceTable* Table = GetTable();
+	return Table ? ToTeam(Table->GetColor(PieceId)) : ETeam::White;
+}
+
+int32 AChessPieces::GetBoardRow() const
+{
+	const FChessPieceTable* Table = GetTable();
+	return Table && !Table->IsCaptured(PieceId) ? ChessSquare::Row(Table->GetSquare(PieceId)) : INDEX_NONE;
+}
+
+int32 AChessPieces::GetBoardCol() const
+{
+	const FChessPieceTable* Table = GetTable();
+	return Table && !Table->IsCaptured(PieceId) ? ChessSquare::Col(Table->GetSquare(PieceId)) : INDEX_NONE;
+}
+
+bool AChessPieces::HasMoved() const
+{
+	const FChessPieceTable* Table = GetTable();
+	return Table && Table->HasFlag(PieceId, EChessPieceFlags::HasMoved);
+}
+
+bool AChessPieces::JustDoubleMoved() const
+{
+	const FChessPieceTable* Table = GetTable();
+	return Table && Table->HasFlag(PieceId, EChessPieceFlags::JustDoubleMoved);
 }
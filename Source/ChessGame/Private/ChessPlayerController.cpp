@@ -1,4 +1,5 @@
 ﻿#include "ChessPlayerController.h"
+#include "ChessGame.h"
 #include "EnhancedInputComponent.h"
 #include "Kismet/GameplayStatics.h"
 #include "ChessPieces.h"
@@ -39,6 +40,49 @@ void AChessPlayerController::BeginPlay()
     LastMoveEnd = FVector2D(-1, -1);
 }
 
+void AChessPlayerController::NewGame()
+{
+    if (!ChessBoardRef) return;
+
+    ChessBoardRef->ResetGame();
+
+    SelectedPiece = nullptr;
+    PossibleMoves.Empty();
+    CurrentTurn = ToTeam(ChessBoardRef->GetMatch().GetSideToMove());
+    LastMoveStart = FVector2D(-1, -1);
+    LastMoveEnd = FVector2D(-1, -1);
+}
+
+void AChessPlayerController::UsePieceSet(int32 Index)
+{
+    if (!ChessBoardRef) return;
+
+    if (!ChessBoardRef->AlternativePieceSets.IsValidIndex(Index))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("No piece set %d; the board has %d"), Index, ChessBoardRef->AlternativePieceSets.Num());
+        return;
+    }
+
+    ChessBoardRef->SetPieceSet(ChessBoardRef->AlternativePieceSets[Index]);
+}
+
+void AChessPlayerController::Undo()
+{
+    if (!ChessBoardRef || !ChessBoardRef->UndoMove()) return;
+
+    SelectedPiece = nullptr;
+    PossibleMoves.Empty();
+    CurrentTurn = ToTeam(ChessBoardRef->GetMatch().GetSideToMove());
+    LastMoveStart = FVector2D(-1, -1);
+    LastMoveEnd = FVector2D(-1, -1);
+}
+
+void AChessPlayerController::ToggleAnalysis()
+{
+    if (ChessBoardRef)
+        ChessBoardRef->SetAnalysisEnabled(!ChessBoardRef->bShowAnalysis);
+}
+
 void AChessPlayerController::SetupInputComponent()
 {
     Super::SetupInputComponent();
@@ -53,7 +97,11 @@ void AChessPlayerController::SetupInputComponent()
 void AChessPlayerController::Input_LeftClickAction(const FInputActionValue& Value)
 {
     FHitResult HitResult;
-    GetHitResultUnderCursor(ECC_Visibility, false, HitResult);
+    {
+        SCOPE_CYCLE_COUNTER(STAT_ChessPicking);
+        TRACE_CPUPROFILER_EVENT_SCOPE(AChessPlayerController::Picking);
+        GetHitResultUnderCursor(ECC_Visibility, false, HitResult);
+    }
 
     if (HitResult.bBlockingHit)
         TrySelectOrMovePiece(HitResult.GetActor(), HitResult.Location);
@@ -61,7 +109,7 @@ void AChessPlayerController::Input_LeftClickAction(const FInputActionValue& Valu
 
 void AChessPlayerController::TrySelectOrMovePiece(AActor* ClickedActor, const FVector& ClickLocation)
 {
-    if (!ChessBoardRef) return;
+    if (!ChessBoardRef || ChessBoardRef->GetMatch().IsGameOver()) return;
 
     FVector2D BoardPos = ChessBoardRef->ConvertWorldToBoardPosition(ClickLocation);
     BoardPos.X = FMath::Clamp(FMath::RoundToInt(BoardPos.X), 0, 7);
@@ -75,7 +123,6 @@ void AChessPlayerController::TrySelectOrMovePiece(AActor* ClickedActor, const FV
         {
             MoveSelectedPiece(BoardPos);
             ChessBoardRef->ClearHighlights();
-            CurrentTurn = (CurrentTurn == ETeam::White) ? ETeam::Black : ETeam::White;
         }
         else if (!ClickedPiece)
         {
@@ -83,14 +130,14 @@ void AChessPlayerController::TrySelectOrMovePiece(AActor* ClickedActor, const FV
             PossibleMoves.Empty();
             ChessBoardRef->ClearHighlights();
         }
-        else if (ClickedPiece->Team == CurrentTurn)
+        else if (ClickedPiece->GetTeam() == CurrentTurn)
         {
             SelectedPiece = ClickedPiece;
             CalculatePossibleMoves();
             ChessBoardRef->ShowHighlights(PossibleMoves);
         }
     }
-    else if (ClickedPiece && ClickedPiece->Team == CurrentTurn)
+    else if (ClickedPiece && ClickedPiece->GetTeam() == CurrentTurn)
     {
         SelectedPiece = ClickedPiece;
         CalculatePossibleMoves();
@@ -100,142 +147,12 @@ void AChessPlayerController::TrySelectOrMovePiece(AActor* ClickedActor, const FV
 
 void AChessPlayerController::CalculatePossibleMoves()
 {
-    if (!SelectedPiece || !ChessBoardRef) return;
-
-    PossibleMoves.Empty();
-    EnPassantTarget = nullptr;
-
-    int32 Row = SelectedPiece->BoardRow;
-    int32 Col = SelectedPiece->BoardCol;
-
-    auto AddMoveLine = [&](int32 R, int32 C) -> bool
-        {
-            if (R < 0 || R >= 8 || C < 0 || C >= 8) return false;
-            AChessPieces* Target = ChessBoardRef->GetPieceAt(R, C);
-            if (!Target) { PossibleMoves.Add(FVector2D(R, C)); return true; }
-            if (Target->Team != SelectedPiece->Team) { PossibleMoves.Add(FVector2D(R, C)); return false; }
-            return false;
-        };
-
-    auto AddPawnCapture = [&](int32 R, int32 C)
-        {
-            if (R < 0 || R >= 8 || C < 0 || C >= 8) return;
-            AChessPieces* Target = ChessBoardRef->GetPieceAt(R, C);
-            if (Target && Target->Team != SelectedPiece->Team)
-                PossibleMoves.Add(FVector2D(R, C));
-        };
-
-    switch (SelectedPiece->PieceType)
-    {
-    case EPieceType::Pawn:
-    {
-        int32 Dir = (SelectedPiece->Team == ETeam::White) ? 1 : -1;
-        int32 StartRow = (SelectedPiece->Team == ETeam::White) ? 1 : 6;
+    SCOPE_CYCLE_COUNTER(STAT_ChessCalculatePossibleMoves);
+    TRACE_CPUPROFILER_EVENT_SCOPE(AChessPlayerController::CalculatePossibleMoves);
 
-        if (!ChessBoardRef->GetPieceAt(Row + Dir, Col))
-        {
-            PossibleMoves.Add(FVector2D(Row + Dir, Col));
-            if (Row == StartRow && !ChessBoardRef->GetPieceAt(Row + 2 * Dir, Col))
-                PossibleMoves.Add(FVector2D(Row + 2 * Dir, Col));
-        }
-
-        AddPawnCapture(Row + Dir, Col - 1);
-        AddPawnCapture(Row + Dir, Col + 1);
+    if (!SelectedPiece || !ChessBoardRef) return;
 
-        if (LastMoveStart != FVector2D(-1, -1))
-        {
-            if (FMath::Abs(LastMoveStart.X - LastMoveEnd.X) == 2)
-            {
-                int32 LastRow = LastMoveEnd.X;
-                int32 LastCol = LastMoveEnd.Y;
-                for (int dc = -1; dc <= 1; dc += 2)
-                {
-                    int32 AdjCol = Col + dc;
-                    if (AdjCol < 0 || AdjCol >= 8) continue;
-                    AChessPieces* AdjPiece = ChessBoardRef->GetPieceAt(Row, AdjCol);
-                    if (AdjPiece && AdjPiece->BoardRow == LastRow && AdjPiece->BoardCol == LastCol)
-                    {
-                        PossibleMoves.Add(FVector2D(Row + Dir, AdjCol));
-                        EnPassantTarget = AdjPiece;
-                    }
-                }
-            }
-        }
-        break;
-    }
-    case EPieceType::Rook:
-    case EPieceType::Bishop:
-    case EPieceType::Queen:
-    {
-        TArray<FVector2D> Directions;
-        if (SelectedPiece->PieceType == EPieceType::Rook)
-            Directions = { {1,0}, {-1,0}, {0,1}, {0,-1} };
-        else if (SelectedPiece->PieceType == EPieceType::Bishop)
-            Directions = { {1,1}, {1,-1}, {-1,1}, {-1,-1} };
-        else
-            Directions = { {1,0}, {-1,0}, {0,1}, {0,-1}, {1,1}, {1,-1}, {-1,1}, {-1,-1} };
-
-        for (auto& D : Directions)
-            for (int32 i = 1; i < 8; ++i)
-                if (!AddMoveLine(Row + D.X * i, Col + D.Y * i)) break;
-        break;
-    }
-    case EPieceType::Knight:
-    {
-        const int32 Moves[8][2] = { {2,1},{1,2},{-1,2},{-2,1},{-2,-1},{-1,-2},{1,-2},{2,-1} };
-        for (auto& M : Moves)
-        {
-            int32 R = Row + M[0], C = Col + M[1];
-            if (R >= 0 && R < 8 && C >= 0 && C < 8)
-            {
-                AChessPieces* Target = ChessBoardRef->GetPieceAt(R, C);
-                if (!Target || Target->Team != SelectedPiece->Team)
-                    PossibleMoves.Add(FVector2D(R, C));
-            }
-        }
-        break;
-    }
-    case EPieceType::King:
-    {
-        for (int dr = -1; dr <= 1; ++dr)
-            for (int dc = -1; dc <= 1; ++dc)
-            {
-                if (dr == 0 && dc == 0) continue;
-                int32 R = Row + dr, C = Col + dc;
-                if (R >= 0 && R < 8 && C >= 0 && C < 8)
-                {
-                    AChessPieces* Target = ChessBoardRef->GetPieceAt(R, C);
-                    if (!Target || Target->Team != SelectedPiece->Team)
-                        PossibleMoves.Add(FVector2D(R, C));
-                }
-            }
-
-        if (!SelectedPiece->bHasMoved)
-        {
-            if (AChessPieces* Rook = ChessBoardRef->GetPieceAt(Row, 7))
-            {
-                if (Rook->PieceType == EPieceType::Rook && !Rook->bHasMoved)
-                {
-                    bool bClear = true;
-                    for (int c = Col + 1; c < 7; c++)
-                        if (ChessBoardRef->GetPieceAt(Row, c)) bClear = false;
-                    if (bClear) PossibleMoves.Add(FVector2D(Row, Col + 2));
-                }
-            }
-            if (AChessPieces* Rook = ChessBoardRef->GetPieceAt(Row, 0))
-            {
-                if (Rook->PieceType == EPieceType::Rook && !Rook->bHasMoved)
-                {
-                    bool bClear = true;
-                    for (int c = Col - 1; c > 0; c--)
-                        if (ChessBoardRef->GetPieceAt(Row, c)) bClear = false;
-                    if (bClear) PossibleMoves.Add(FVector2D(Row, Col - 2));
-                }
-            }
-        }
-        break;
-    }
-    }
+    ChessBoardRef->GetLegalMoves(SelectedPiece->GetBoardRow(), SelectedPiece->GetBoardCol(), PossibleMoves);
 }
 
 bool AChessPlayerController::IsValidMove(const FVector2D& TargetPosition)
@@ -250,89 +167,43 @@ bool AChessPlayerController::IsValidMove(const FVector2D& TargetPosition)
 
 void AChessPlayerController::MoveSelectedPiece(const FVector2D& TargetPosition)
 {
-    if (!SelectedPiece || !ChessBoardRef) return;
+    SCOPE_CYCLE_COUNTER(STAT_ChessMoveSelectedPiece);
+    TRACE_CPUPROFILER_EVENT_SCOPE(AChessPlayerController::MoveSelectedPiece);
 
-    FVector2D OldPos(SelectedPiece->BoardRow, SelectedPiece->BoardCol);
-    LastMoveStart = OldPos;
-    LastMoveEnd = TargetPosition;
-    int32 Row = OldPos.X;
-    int32 Col = OldPos.Y;
-
-    if (AChessPieces* Target = ChessBoardRef->GetPieceAt(TargetPosition.X, TargetPosition.Y))
-    {
-        if (Target->Team != SelectedPiece->Team)
-        {
-            ChessBoardRef->SetPieceAt(Target->BoardRow, Target->BoardCol, nullptr);
-            Target->Destroy();
-        }
-    }
+    if (!SelectedPiece || !ChessBoardRef) return;
 
-    if (SelectedPiece->PieceType == EPieceType::Pawn && EnPassantTarget)
-    {
-        if (TargetPosition.Y != OldPos.Y && !ChessBoardRef->GetPieceAt(TargetPosition.X, TargetPosition.Y))
-        {
-            if (EnPassantTarget->BoardRow == OldPos.X && EnPassantTarget->BoardCol == TargetPosition.Y)
-            {
-                ChessBoardRef->SetPieceAt(EnPassantTarget->BoardRow, EnPassantTarget->BoardCol, nullptr);
-                EnPassantTarget->Destroy();
-            }
-        }
-        EnPassantTarget = nullptr;
-    }
+    int32 FromRow = SelectedPiece->GetBoardRow();
+    int32 FromCol = SelectedPiece->GetBoardCol();
+    int32 ToRow = FMath::RoundToInt(TargetPosition.X);
+    int32 ToCol = FMath::RoundToInt(TargetPosition.Y);
 
-    if (SelectedPiece->PieceType == EPieceType::King)
+    if (ChessBoardRef->ApplyMove(FromRow, FromCol, ToRow, ToCol))
     {
-        if (TargetPosition.Y == Col + 2)
-        {
-            AChessPieces* Rook = ChessBoardRef->GetPieceAt(Row, 7);
-            if (Rook)
-            {
-                ChessBoardRef->SetPieceAt(Row, 7, nullptr);
-                ChessBoardRef->SetPieceAt(Row, Col + 1, Rook);
-                Rook->BoardCol = Col + 1;
-                Rook->bHasMoved = true;
-                Rook->SetActorLocation(ChessBoardRef->GetTileWorldPosition(Row, Col + 1));
-            }
-        }
-        else if (TargetPosition.Y == Col - 2)
-        {
-            AChessPieces* Rook = ChessBoardRef->GetPieceAt(Row, 0);
-            if (Rook)
-            {
-                ChessBoardRef->SetPieceAt(Row, 0, nullptr);
-                ChessBoardRef->SetPieceAt(Row, Col - 1, Rook);
-                Rook->BoardCol = Col - 1;
-                Rook->bHasMoved = true;
-                Rook->SetActorLocation(ChessBoardRef->GetTileWorldPosition(Row, Col - 1));
-            }
-        }
+        LastMoveStart = FVector2D(FromRow, FromCol);
+        LastMoveEnd = FVector2D(ToRow, ToCol);
+        CurrentTurn = ToTeam(ChessBoardRef->GetMatch().GetSideToMove());
+
+        if (IsCheckmate(CurrentTurn))
+            UE_LOG(LogTemp, Log, TEXT("Checkmate, %s wins"), CurrentTurn == ETeam::White ? TEXT("Black") : TEXT("White"));
+        else if (ChessBoardRef->GetMatch().IsGameOver())
+            UE_LOG(LogTemp, Log, TEXT("Game drawn"));
+        else if (IsInCheck(CurrentTurn))
+            UE_LOG(LogTemp, Log, TEXT("%s is in check"), CurrentTurn == ETeam::White ? TEXT("White") : TEXT("Black"));
     }
 
-    ChessBoardRef->SetPieceAt(OldPos.X, OldPos.Y, nullptr);
-    SelectedPiece->BoardRow = FMath::RoundToInt(TargetPosition.X);
-    SelectedPiece->BoardCol = FMath::RoundToInt(TargetPosition.Y);
-    ChessBoardRef->SetPieceAt(SelectedPiece->BoardRow, SelectedPiece->BoardCol, SelectedPiece);
-
-    FVector TargetLoc = ChessBoardRef->GetTileWorldPosition(SelectedPiece->BoardRow, SelectedPiece->BoardCol);
-    float PieceZ = ChessBoardRef->GetSafeZOffset(SelectedPiece->PieceMesh ? SelectedPiece->PieceMesh->GetStaticMesh() : nullptr, 0.f);
-    SelectedPiece->SetActorLocation(TargetLoc + FVector(0, 0, PieceZ));
-
-    SelectedPiece->bHasMoved = true;
-
     SelectedPiece = nullptr;
     PossibleMoves.Empty();
 }
 
-void AChessPlayerController::MoveRookForCastle(int32 Row, int32 RookCol, int32 TargetCol)
+bool AChessPlayerController::IsInCheck(ETeam Team)
 {
-    if (AChessPieces* Rook = ChessBoardRef->GetPieceAt(Row, RookCol))
-    {
-        ChessBoardRef->SetPieceAt(Row, RookCol, nullptr);
-        ChessBoardRef->SetPieceAt(Row, TargetCol, Rook);
-        Rook->BoardCol = TargetCol;
-        Rook->bHasMoved = true;
-        FVector TargetLoc = ChessBoardRef->GetTileWorldPosition(Row, TargetCol);
-        if (Rook->PieceMesh) Rook->PieceMesh->SetWorldLocation(TargetLoc + FVector(0, 0, 0));
-        else Rook->SetActorLocation(TargetLoc + FVector(0, 0, 0));
-    }
+    return ChessBoardRef && ChessBoardRef->GetMatch().GetPosition().IsInCheck(ToChessColor(Team));
+}
+
+bool AChessPlayerController::IsCheckmate(ETeam Team)
+{
+    if (!ChessBoardRef) return false;
+
+    const FChessMatch& Match = ChessBoardRef->GetMatch();
+    return Match.GetStatus() == EChessGameStatus::Checkmate && Match.GetSideToMove() == ToChessColor(Team);
 }
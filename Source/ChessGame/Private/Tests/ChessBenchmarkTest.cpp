@@ -0,0 +1,363 @@
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "ChessBoardActor.h"
+#include "ChessGame.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/ConfigCacheIni.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonWriter.h"
+#include "Tests/AutomationCommon.h"
+#include "UObject/UObjectGlobals.h"
+
+/**
+ * Frame-time and memory regression benchmark for board spawning and play.
+ *
+ * Loads MainLevel, clones the level's board N times, then plays a scripted game on every
+ * clone, one ply per frame, the same way a player's clicks would (legal moves, highlights,
+ * move, clear), then starts a new game on each, which must not spawn anything. Results go to Saved/Benchmarks as JSON and CSV; the test fails if any
+ * threshold from the [ChessBenchmark] section of DefaultGame.ini is exceeded.
+ *
+ * Headless on Linux:
+ *   UnrealEditor ChessGame.uproject -game -nullrhi -nosound -unattended
+ *       -ExecCmds="Automation RunTests Chess.Benchmark; Quit" [-ChessBenchBoards=N]
+ */
+namespace ChessBenchmark
+{
+	const TCHAR* ConfigSection = TEXT("ChessBenchmark");
+	const TCHAR* MapName = TEXT("/Game/Levels/MainLevel");
+
+	// Italian game: development, captures and castling on both sides.
+	const TCHAR* ScriptedMoves[] =
+	{
+		TEXT("e2e4"), TEXT("e7e5"), TEXT("g1f3"), TEXT("b8c6"), TEXT("f1c4"), TEXT("f8c5"),
+		TEXT("c2c3"), TEXT("g8f6"), TEXT("d2d4"), TEXT("e5d4"), TEXT("c3d4"), TEXT("c5b4"),
+		TEXT("b1c3"), TEXT("f6e4"), TEXT("e1g1"), TEXT("b4c3"), TEXT("d4d5"), TEXT("c3f6"),
+		TEXT("f1e1"), TEXT("c6e7"), TEXT("e1e4"), TEXT("d7d6"), TEXT("c1g5"), TEXT("f6g5"),
+		TEXT("f3g5"), TEXT("e8g8"), TEXT("g5h7"), TEXT("g8h7"), TEXT("d1h5"), TEXT("h7g8"),
+		TEXT("e4h4"), TEXT("f7f5"),
+	};
+
+	struct FSettings
+	{
+		int32 NumBoards = 8;
+		double MaxSpawnMsPerBoard = 50.0;
+		double MaxMoveMs = 16.0;
+		int32 MaxGCPauses = 2;
+		double MaxMemoryGrowthMB = 256.0;
+
+		void Load()
+		{
+			if (GConfig)
+			{
+				GConfig->GetInt(ConfigSection, TEXT("NumBoards"), NumBoards, GGameIni);
+				GConfig->GetDouble(ConfigSection, TEXT("MaxSpawnMsPerBoard"), MaxSpawnMsPerBoard, GGameIni);
+				GConfig->GetDouble(ConfigSection, TEXT("MaxMoveMs"), MaxMoveMs, GGameIni);
+				GConfig->GetInt(ConfigSection, TEXT("MaxGCPauses"), MaxGCPauses, GGameIni);
+				GConfig->GetDouble(ConfigSection, TEXT("MaxMemoryGrowthMB"), MaxMemoryGrowthMB, GGameIni);
+			}
+			FParse::Value(FCommandLine::Get(), TEXT("ChessBenchBoards="), NumBoards);
+			NumBoards = FMath::Max(1, NumBoards);
+		}
+	};
+
+	struct FMoveSample
+	{
+		FString Move;
+
+		/** Slowest single board's select-and-move for this ply; what MaxMoveMs is checked against. */
+		double MoveMs = 0.0;
+
+		/** All boards together, i.e. the game-thread cost of the ply's frame. */
+		double GameThreadMs = 0.0;
+		double FrameMs = 0.0;
+	};
+
+	struct FRun
+	{
+		FSettings Settings;
+		TWeakObjectPtr<UWorld> World;
+		TArray<TWeakObjectPtr<AChessBoardActor>> Boards;
+
+		double SpawnMs = 0.0;
+		double ResetMs = 0.0;
+		int32 ResetSpawns = 0;
+		TArray<FMoveSample> Moves;
+		int32 NextPly = 0;
+
+		int32 GCPauses = 0;
+		double GCPauseMs = 0.0;
+		double GCStartTime = 0.0;
+		FDelegateHandle PreGCHandle;
+		FDelegateHandle PostGCHandle;
+
+		uint64 MemoryAtStart = 0;
+		uint64 MemoryHighWater = 0;
+
+		void SampleMemory()
+		{
+			MemoryHighWater = FMath::Max<uint64>(MemoryHighWater, FPlatformMemory::GetStats().UsedPhysical);
+		}
+
+		void BeginGCTracking()
+		{
+			PreGCHandle = FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddLambda([this]()
+				{
+					GCStartTime = FPlatformTime::Seconds();
+				});
+			PostGCHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddLambda([this]()
+				{
+					++GCPauses;
+					GCPauseMs += (FPlatformTime::Seconds() - GCStartTime) * 1000.0;
+				});
+		}
+
+		void EndGCTracking()
+		{
+			FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(PreGCHandle);
+			FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGCHandle);
+		}
+	};
+
+	UWorld* FindGameWorld()
+	{
+		if (!GEngine) return nullptr;
+
+		for (const FWorldContext& Context : GEngine->GetWorldContexts())
+			if ((Context.WorldType == EWorldType::Game || Context.WorldType == EWorldType::PIE) && Context.World())
+				return Context.World();
+		return nullptr;
+	}
+
+	double MegaBytes(uint64 Bytes)
+	{
+		return Bytes / (1024.0 * 1024.0);
+	}
+}
+
+DEFINE_LATENT_AUTOMATION_COMMAND_TWO_PARAMETER(FChessBenchmarkSpawnCommand, TSharedRef<ChessBenchmark::FRun>, Run, FAutomationTestBase*, Test);
+
+bool FChessBenchmarkSpawnCommand::Update()
+{
+	UWorld* World = ChessBenchmark::FindGameWorld();
+	if (!World || !World->HasBegunPlay())
+		return false;
+
+	TActorIterator<AChessBoardActor> It(World);
+	AChessBoardActor* Template = It ? *It : nullptr;
+	if (!Template)
+	{
+		Test->AddError(TEXT("MainLevel has no AChessBoardActor to clone"));
+		return true;
+	}
+
+	Run->World = World;
+	Run->MemoryAtStart = FPlatformMemory::GetStats().UsedPhysical;
+	Run->MemoryHighWater = Run->MemoryAtStart;
+	Run->BeginGCTracking();
+
+	// Line the clones up beside the level board, one and a half board widths apart.
+	const float Spacing = FMath::Max(Template->GetTileSizeY() * 8.f * 1.5f, 100.f);
+
+	const double StartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < Run->Settings.NumBoards; ++i)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.Template = Template;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		const FVector Location = Template->GetActorLocation() + FVector(0.f, Spacing * (i + 1), 0.f);
+		AChessBoardActor* Board = World->SpawnActor<AChessBoardActor>(Template->GetClass(), Location, Template->GetActorRotation(), SpawnParams);
+		if (Board)
+			Run->Boards.Add(Board);
+	}
+	Run->SpawnMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	Run->SampleMemory();
+
+	if (Run->Boards.Num() != Run->Settings.NumBoards)
+		Test->AddError(FString::Printf(TEXT("Spawned %d of %d boards"), Run->Boards.Num(), Run->Settings.NumBoards));
+
+	return true;
+}
+
+DEFINE_LATENT_AUTOMATION_COMMAND_TWO_PARAMETER(FChessBenchmarkPlayCommand, TSharedRef<ChessBenchmark::FRun>, Run, FAutomationTestBase*, Test);
+
+bool FChessBenchmarkPlayCommand::Update()
+{
+	// The previous ply ran during the last frame; its full frame time is known now.
+	if (Run->Moves.Num() > 0)
+		Run->Moves.Last().FrameMs = FApp::GetDeltaTime() * 1000.0;
+	Run->SampleMemory();
+
+	if (Run->NextPly >= UE_ARRAY_COUNT(ChessBenchmark::ScriptedMoves) || Run->Boards.Num() == 0)
+		return true;
+
+	const FString MoveText = ChessBenchmark::ScriptedMoves[Run->NextPly++];
+	const int32 From = ChessSquare::FromString(MoveText.Left(2));
+	const int32 To = ChessSquare::FromString(MoveText.Mid(2, 2));
+	const int32 FromRow = ChessSquare::Row(From), FromCol = ChessSquare::Col(From);
+	const int32 ToRow = ChessSquare::Row(To), ToCol = ChessSquare::Col(To);
+
+	ChessBenchmark::FMoveSample& Sample = Run->Moves.AddDefaulted_GetRef();
+	Sample.Move = MoveText;
+
+	for (const TWeakObjectPtr<AChessBoardActor>& BoardPtr : Run->Boards)
+	{
+		AChessBoardActor* Board = BoardPtr.Get();
+		if (!Board) continue;
+
+		// Same calls a player's select-then-move clicks make, timed per board so the threshold
+		// does not tighten as boards are added.
+		const double StartTime = FPlatformTime::Seconds();
+		TArray<FVector2D> Targets;
+		Board->GetLegalMoves(FromRow, FromCol, Targets);
+		Board->ShowHighlights(Targets);
+		if (!Board->ApplyMove(FromRow, FromCol, ToRow, ToCol))
+			Test->AddError(FString::Printf(TEXT("Scripted move %s rejected on %s"), *MoveText, *Board->GetName()));
+		Board->ClearHighlights();
+
+		const double BoardMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+		Sample.MoveMs = FMath::Max(Sample.MoveMs, BoardMs);
+		Sample.GameThreadMs += BoardMs;
+	}
+
+	return false;
+}
+
+DEFINE_LATENT_AUTOMATION_COMMAND_TWO_PARAMETER(FChessBenchmarkReportCommand, TSharedRef<ChessBenchmark::FRun>, Run, FAutomationTestBase*, Test);
+
+bool FChessBenchmarkReportCommand::Update()
+{
+	using namespace ChessBenchmark;
+
+	// A new game has to come entirely out of each board's piece pool.
+	const double ResetStart = FPlatformTime::Seconds();
+	for (const TWeakObjectPtr<AChessBoardActor>& Board : Run->Boards)
+	{
+		if (!Board.IsValid()) continue;
+		const int32 PoolSize = Board->PiecePool.Num();
+		Board->ResetGame();
+		Run->ResetSpawns += Board->PiecePool.Num() - PoolSize;
+	}
+	Run->ResetMs = (FPlatformTime::Seconds() - ResetStart) * 1000.0;
+
+	Run->EndGCTracking();
+	for (const TWeakObjectPtr<AChessBoardActor>& Board : Run->Boards)
+		if (Board.IsValid()) Board->Destroy();
+
+	const FSettings& Settings = Run->Settings;
+	const int32 NumBoards = FMath::Max(1, Run->Boards.Num());
+	const double SpawnMsPerBoard = Run->SpawnMs / NumBoards;
+
+	double MaxMoveMs = 0.0;
+	double TotalMoveMs = 0.0;
+	double MaxGameThreadMs = 0.0;
+	for (const FMoveSample& Sample : Run->Moves)
+	{
+		MaxMoveMs = FMath::Max(MaxMoveMs, Sample.MoveMs);
+		TotalMoveMs += Sample.GameThreadMs;
+		MaxGameThreadMs = FMath::Max(MaxGameThreadMs, Sample.GameThreadMs);
+	}
+	// Mean over every board's moves, so it is comparable across board counts.
+	const double MeanMoveMs = Run->Moves.Num() > 0 ? TotalMoveMs / (Run->Moves.Num() * NumBoards) : 0.0;
+	const double MemoryGrowthMB = MegaBytes(Run->MemoryHighWater - FMath::Min(Run->MemoryAtStart, Run->MemoryHighWater));
+
+	TArray<FString> Failures;
+	if (SpawnMsPerBoard > Settings.MaxSpawnMsPerBoard)
+		Failures.Add(FString::Printf(TEXT("Spawn %.2f ms/board exceeds %.2f"), SpawnMsPerBoard, Settings.MaxSpawnMsPerBoard));
+	if (Run->ResetSpawns > 0)
+		Failures.Add(FString::Printf(TEXT("Game reset spawned %d piece actors"), Run->ResetSpawns));
+	if (MaxMoveMs > Settings.MaxMoveMs)
+		Failures.Add(FString::Printf(TEXT("Worst single-board move %.2f ms exceeds %.2f"), MaxMoveMs, Settings.MaxMoveMs));
+	if (Run->GCPauses > Settings.MaxGCPauses)
+		Failures.Add(FString::Printf(TEXT("%d GC pauses exceeds %d"), Run->GCPauses, Settings.MaxGCPauses));
+	if (MemoryGrowthMB > Settings.MaxMemoryGrowthMB)
+		Failures.Add(FString::Printf(TEXT("Memory growth %.1f MB exceeds %.1f"), MemoryGrowthMB, Settings.MaxMemoryGrowthMB));
+
+	FString Json;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	Writer->WriteObjectStart();
+	Writer->WriteValue(TEXT("passed"), Failures.Num() == 0);
+	Writer->WriteValue(TEXT("boards"), NumBoards);
+	Writer->WriteValue(TEXT("plies"), Run->Moves.Num());
+	Writer->WriteValue(TEXT("spawnMs"), Run->SpawnMs);
+	Writer->WriteValue(TEXT("spawnMsPerBoard"), SpawnMsPerBoard);
+	Writer->WriteValue(TEXT("resetMs"), Run->ResetMs);
+	Writer->WriteValue(TEXT("resetSpawns"), Run->ResetSpawns);
+	Writer->WriteValue(TEXT("meanMoveMs"), MeanMoveMs);
+	Writer->WriteValue(TEXT("maxMoveMs"), MaxMoveMs);
+	Writer->WriteValue(TEXT("maxGameThreadMs"), MaxGameThreadMs);
+	Writer->WriteValue(TEXT("gcPauses"), Run->GCPauses);
+	Writer->WriteValue(TEXT("gcPauseMs"), Run->GCPauseMs);
+	Writer->WriteValue(TEXT("memoryAtStartMB"), MegaBytes(Run->MemoryAtStart));
+	Writer->WriteValue(TEXT("memoryHighWaterMB"), MegaBytes(Run->MemoryHighWater));
+	Writer->WriteValue(TEXT("memoryGrowthMB"), MemoryGrowthMB);
+	Writer->WriteValue(TEXT("processPeakMB"), MegaBytes(FPlatformMemory::GetStats().PeakUsedPhysical));
+
+	Writer->WriteObjectStart(TEXT("thresholds"));
+	Writer->WriteValue(TEXT("maxSpawnMsPerBoard"), Settings.MaxSpawnMsPerBoard);
+	Writer->WriteValue(TEXT("maxMoveMs"), Settings.MaxMoveMs);
+	Writer->WriteValue(TEXT("maxGCPauses"), Settings.MaxGCPauses);
+	Writer->WriteValue(TEXT("maxMemoryGrowthMB"), Settings.MaxMemoryGrowthMB);
+	Writer->WriteObjectEnd();
+
+	Writer->WriteArrayStart(TEXT("failures"));
+	for (const FString& Failure : Failures)
+		Writer->WriteValue(Failure);
+	Writer->WriteArrayEnd();
+
+	Writer->WriteArrayStart(TEXT("moves"));
+	for (const FMoveSample& Sample : Run->Moves)
+	{
+		Writer->WriteObjectStart();
+		Writer->WriteValue(TEXT("move"), Sample.Move);
+		Writer->WriteValue(TEXT("moveMs"), Sample.MoveMs);
+		Writer->WriteValue(TEXT("gameThreadMs"), Sample.GameThreadMs);
+		Writer->WriteValue(TEXT("frameMs"), Sample.FrameMs);
+		Writer->WriteObjectEnd();
+	}
+	Writer->WriteArrayEnd();
+	Writer->WriteObjectEnd();
+	Writer->Close();
+
+	FString Csv = TEXT("Ply,Move,MoveMs,GameThreadMs,FrameMs\n");
+	for (int32 i = 0; i < Run->Moves.Num(); ++i)
+		Csv += FString::Printf(TEXT("%d,%s,%.4f,%.4f,%.4f\n"), i + 1, *Run->Moves[i].Move, Run->Moves[i].MoveMs, Run->Moves[i].GameThreadMs, Run->Moves[i].FrameMs);
+
+	const FString BaseName = FPaths::ProjectSavedDir() / TEXT("Benchmarks") / FString::Printf(TEXT("ChessBenchmark-%s"), *FDateTime::Now().ToString());
+	FFileHelper::SaveStringToFile(Json, *(BaseName + TEXT(".json")));
+	FFileHelper::SaveStringToFile(Csv, *(BaseName + TEXT(".csv")));
+
+	Test->AddInfo(FString::Printf(TEXT("%d boards: spawn %.2f ms/board, move mean %.3f ms max %.3f ms, %d GC pauses, memory +%.1f MB. Results: %s.json"),
+		NumBoards, SpawnMsPerBoard, MeanMoveMs, MaxMoveMs, Run->GCPauses, MemoryGrowthMB, *BaseName));
+	for (const FString& Failure : Failures)
+		Test->AddError(Failure);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessBenchmarkSpawnAndPlayTest, "Chess.Benchmark.SpawnAndPlay",
+	EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+bool FChessBenchmarkSpawnAndPlayTest::RunTest(const FString& Parameters)
+{
+	TSharedRef<ChessBenchmark::FRun> Run = MakeShared<ChessBenchmark::FRun>();
+	Run->Settings.Load();
+
+	AutomationOpenMap(ChessBenchmark::MapName);
+	ADD_LATENT_AUTOMATION_COMMAND(FChessBenchmarkSpawnCommand(Run, this));
+	ADD_LATENT_AUTOMATION_COMMAND(FChessBenchmarkPlayCommand(Run, this));
+	ADD_LATENT_AUTOMATION_COMMAND(FChessBenchmarkReportCommand(Run, this));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -3,8 +3,13 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "ChessPieces.h"
+#include "ChessMatch.h"
+#include "ChessAnalysis.h"
+#include "ChessPieceSet.h"
 #include "ChessBoardActor.generated.h"
 
+struct FStreamableHandle;
+
 UCLASS()
 class CHESSGAME_API AChessBoardActor : public AActor
 {
@@ -28,19 +33,16 @@ public:
 	UPROPERTY(EditAnywhere, Category = "Chess Pieces")
 	TSubclassOf<AChessPieces> ChessPieceClass;
 
-	UPROPERTY(EditAnywhere, Category = "Chess Pieces") UStaticMesh* WhitePawn;
-	UPROPERTY(EditAnywhere, Category = "Chess Pieces") UStaticMesh* WhiteRook;
-	UPROPERTY(EditAnywhere, Category = "Chess Pieces") UStaticMesh* WhiteKnight;
-	UPROPERTY(EditAnywhere, Category = "Chess Pieces") UStaticMesh* WhiteBishop;
-	UPROPERTY(EditAnywhere, Category = "Chess Pieces") UStaticMesh* WhiteQueen;
-	UPROPERTY(EditAnywhere, Category = "Chess Pieces") UStaticMesh* WhiteKing;
+	/**
+	 * Piece meshes. Streamed in after BeginPlay and never loaded on dedicated servers. Left empty,
+	 * the board uses the UChessPieceSet class defaults, which point at the shipped meshes.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Chess Pieces")
+	UChessPieceSet* PieceSet;
 
-	UPROPERTY(EditAnywhere, Category = "Chess Pieces") UStaticMesh* BlackPawn;
-	UPROPERTY(EditAnywhere, Category = "Chess Pieces") UStaticMesh* BlackRook;
-	UPROPERTY(EditAnywhere, Category = "Chess Pieces") UStaticMesh* BlackKnight;
-	UPROPERTY(EditAnywhere, Category = "Chess Pieces") UStaticMesh* BlackBishop;
-	UPROPERTY(EditAnywhere, Category = "Chess Pieces") UStaticMesh* BlackQueen;
-	UPROPERTY(EditAnywhere, Category = "Chess Pieces") UStaticMesh* BlackKing;
+	/** Other sets the board can switch to at runtime with SetPieceSet. */
+	UPROPERTY(EditAnywhere, Category = "Chess Pieces")
+	TArray<UChessPieceSet*> AlternativePieceSets;
 
 	UPROPERTY(EditAnywhere, Category = "Board")
 	UStaticMesh* HighlightMesh;
@@ -48,8 +50,34 @@ public:
 	UPROPERTY(Transient)
 	TArray<UStaticMeshComponent*> HighlightTiles;
 
+	/** Runs a background multi-PV search on the current position and marks the best moves on the board. */
+	UPROPERTY(EditAnywhere, Category = "Analysis")
+	bool bShowAnalysis = false;
+
+	UPROPERTY(EditAnywhere, Category = "Analysis", meta = (ClampMin = "1", ClampMax = "8"))
+	int32 AnalysisLines = 3;
+
+	UPROPERTY(EditAnywhere, Category = "Analysis", meta = (ClampMin = "1", ClampMax = "32"))
+	int32 AnalysisDepth = 10;
+
+	/** Placed on the from and to squares of each suggested move, smaller for weaker lines. */
+	UPROPERTY(EditAnywhere, Category = "Analysis")
+	UStaticMesh* AnalysisMarkerMesh;
+
+	UPROPERTY(Transient)
+	TArray<UStaticMeshComponent*> AnalysisMarkers;
+
+	/** Actor showing each entry of the piece table, indexed by piece id. Null for captured pieces. */
 	UPROPERTY()
-	TArray<AChessPieces*> BoardGrid;
+	TArray<AChessPieces*> PieceActors;
+
+	/** Every piece actor this board has spawned. Captured pieces are hidden and reused rather than destroyed. */
+	UPROPERTY()
+	TArray<AChessPieces*> PiecePool;
+
+	/** Pieces in PiecePool that are off the board and ready to be reused. */
+	UPROPERTY()
+	TArray<AChessPieces*> FreePieces;
 
 	float TileSizeX = 0.f;
 	float TileSizeY = 0.f;
@@ -58,6 +86,7 @@ public:
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
 
@@ -76,23 +105,36 @@ public:
 	UFUNCTION()
 	void SpawnPieces();
 
-	UFUNCTION()
-	int32 GetIndex(int32 Row, int32 Col) const { return Row * 8 + Col; }
+	/** Starts a new game. Pieces are repositioned from the pool, so nothing is spawned after the first game. */
+	UFUNCTION(BlueprintCallable, Category = "Chess Board")
+	void ResetGame();
+
+	/** Takes back the last move. Pieces keep their ids and actors, so references held across a takeback stay valid. */
+	UFUNCTION(BlueprintCallable, Category = "Chess Board")
+	bool UndoMove();
+
+	UFUNCTION(BlueprintCallable, Category = "Analysis")
+	void SetAnalysisEnabled(bool bEnabled);
+
+	/** Best-line evaluation from White's point of view, for an evaluation bar. False until the first result arrives. */
+	UFUNCTION(BlueprintCallable, Category = "Analysis")
+	bool GetEvaluation(int32& OutCentipawns, int32& OutDepth) const;
+
+	const FChessAnalysis& GetShownAnalysis() const { return ShownAnalysis; }
+
+	void ShowAnalysis(const FChessAnalysis& Analysis);
+
+	void ClearAnalysis();
 
 	UFUNCTION()
-	void SetPieceAt(int32 Row, int32 Col, AChessPieces* Piece)
-	{
-		int32 Index = GetIndex(Row, Col);
-		if (BoardGrid.IsValidIndex(Index))
-			BoardGrid[Index] = Piece;
-	}
+	int32 GetIndex(int32 Row, int32 Col) const { return Row * 8 + Col; }
 
 	UFUNCTION()
 	AChessPieces* GetPieceAt(int32 Row, int32 Col) const
 	{
-		int32 Index = GetIndex(Row, Col);
-		if (BoardGrid.IsValidIndex(Index))
-			return BoardGrid[Index];
+		const int32 Id = ChessSquare::IsOnBoard(Row, Col) ? Pieces.GetIdAt(GetIndex(Row, Col)) : FChessPieceTable::NoPiece;
+		if (PieceActors.IsValidIndex(Id))
+			return PieceActors[Id];
 		return nullptr;
 	}
 
@@ -101,4 +143,70 @@ public:
 
 	float GetTileSizeX() const { return TileSizeX; }
 	float GetTileSizeY() const { return TileSizeY; }
+
+	/**
+	 * The mesh for a piece if its set has streamed in, otherwise the placeholder: the set's own, or
+	 * the engine cylinder when the set has none. Never loads on the game thread. Null on dedicated servers.
+	 */
+	UStaticMesh* GetPieceMesh(EPieceType Type, ETeam Team) const;
+
+	/** Switches to another piece set. Pieces keep their current meshes until the new set has loaded. */
+	UFUNCTION(BlueprintCallable, Category = "Chess Pieces")
+	void SetPieceSet(UChessPieceSet* NewSet);
+
+	UFUNCTION(BlueprintCallable, Category = "Chess Pieces")
+	bool IsPieceSetLoaded() const;
+
+	const FChessMatch& GetMatch() const { return Match; }
+
+	/** Which piece is which. The piece actors read their type, team and square from here. */
+	const FChessPieceTable& GetPieceTable() const { return Pieces; }
+
+	/** Legal destinations for the piece on (Row, Col), as (Row, Col) pairs. */
+	void GetLegalMoves(int32 Row, int32 Col, TArray<FVector2D>& OutMoves) const;
+
+	/** Plays a legal move in the match and updates the piece actors to match. Returns false if illegal. */
+	bool ApplyMove(int32 FromRow, int32 FromCol, int32 ToRow, int32 ToCol);
+
+private:
+	/** Takes an actor from the pool, spawning one only if the pool is empty, and binds it to a piece id. */
+	AChessPieces* AcquirePiece(int32 Id);
+
+	/** Hides a piece and returns it to the pool. */
+	void ReleasePiece(AChessPieces* Piece);
+
+	/** Rebuilds the piece table and actors from the match position using the pool. Assigns new ids; for new games. */
+	void SyncPiecesToMatch();
+
+	/** Moves a piece's actor onto the square the table gives it. */
+	void PlacePieceActor(int32 Id, float ZFactor = 0.f);
+
+	/** Points the analysis service at the current position. */
+	void RequestAnalysis();
+
+	/** Picks up newer results for the current position. Called every tick; does nothing until the search has more to show. */
+	void UpdateAnalysisOverlay();
+
+	void LoadPieceSet();
+	void OnPieceSetLoaded();
+	bool ShouldLoadPieceMeshes() const;
+
+	/** Sets a piece's mesh and material from the current set. */
+	void ApplyPieceVisuals(AChessPieces* Piece) const;
+
+	/** Keeps the current set resident; releasing it lets the previous set unload. */
+	TSharedPtr<FStreamableHandle> PieceSetHandle;
+
+	/** Shown while the current set streams in, resolved once per set by LoadPieceSet. */
+	UPROPERTY(Transient)
+	UStaticMesh* PlaceholderMesh;
+
+	/** Rules state for this board. The piece actors mirror it. */
+	FChessMatch Match;
+
+	/** Kept in step with Match on every move; the actors hold only an id into it. */
+	FChessPieceTable Pieces;
+
+	TUniquePtr<FChessAnalysisService> AnalysisService;
+	FChessAnalysis ShownAnalysis;
 };
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "ChessPieces.h"
+#include "ChessPieceSet.generated.h"
+
+class UMaterialInterface;
+class UStaticMesh;
+
+/**
+ * A complete set of piece meshes. Everything is soft-referenced so a set costs nothing until a
+ * board asks for it; boards stream it in and show the placeholder mesh until it arrives.
+ *
+ * New sets start out pointing at the meshes shipped under /Game/Assets/Models/ChessPieces, and a
+ * board with no set assigned uses these class defaults.
+ */
+UCLASS(BlueprintType)
+class CHESSGAME_API UChessPieceSet : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UChessPieceSet();
+
+	/**
+	 * Cheap mesh shown while the set streams in, scaled to fit a tile. Kept low-res so it loads
+	 * instantly. Left empty, boards fall back to GetDefaultPlaceholderMesh.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Chess Pieces")
+	TSoftObjectPtr<UStaticMesh> PlaceholderMesh;
+
+	UPROPERTY(EditAnywhere, Category = "Chess Pieces") TSoftObjectPtr<UStaticMesh> WhitePawn;
+	UPROPERTY(EditAnywhere, Category = "Chess Pieces") TSoftObjectPtr<UStaticMesh> WhiteRook;
+	UPROPERTY(EditAnywhere, Category = "Chess Pieces") TSoftObjectPtr<UStaticMesh> WhiteKnight;
+	UPROPERTY(EditAnywhere, Category = "Chess Pieces") TSoftObjectPtr<UStaticMesh> WhiteBishop;
+	UPROPERTY(EditAnywhere, Category = "Chess Pieces") TSoftObjectPtr<UStaticMesh> WhiteQueen;
+	UPROPERTY(EditAnywhere, Category = "Chess Pieces") TSoftObjectPtr<UStaticMesh> WhiteKing;
+
+	UPROPERTY(EditAnywhere, Category = "Chess Pieces") TSoftObjectPtr<UStaticMesh> BlackPawn;
+	UPROPERTY(EditAnywhere, Category = "Chess Pieces") TSoftObjectPtr<UStaticMesh> BlackRook;
+	UPROPERTY(EditAnywhere, Category = "Chess Pieces") TSoftObjectPtr<UStaticMesh> BlackKnight;
+	UPROPERTY(EditAnywhere, Category = "Chess Pieces") TSoftObjectPtr<UStaticMesh> BlackBishop;
+	UPROPERTY(EditAnywhere, Category = "Chess Pieces") TSoftObjectPtr<UStaticMesh> BlackQueen;
+	UPROPERTY(EditAnywhere, Category = "Chess Pieces") TSoftObjectPtr<UStaticMesh> BlackKing;
+
+	/** Optional per-team material overrides. Left empty, the meshes keep their own materials. */
+	UPROPERTY(EditAnywhere, Category = "Chess Pieces")
+	TSoftObjectPtr<UMaterialInterface> WhiteMaterial;
+
+	UPROPERTY(EditAnywhere, Category = "Chess Pieces")
+	TSoftObjectPtr<UMaterialInterface> BlackMaterial;
+
+	const TSoftObjectPtr<UStaticMesh>& GetMesh(EPieceType Type, ETeam Team) const;
+	const TSoftObjectPtr<UMaterialInterface>& GetMaterial(ETeam Team) const;
+
+	/** The engine cylinder: always cooked, tiny, and what new sets start out with. */
+	static TSoftObjectPtr<UStaticMesh> GetDefaultPlaceholderMesh();
+
+	/** Every asset a board needs resident to show this set, placeholder excluded. */
+	void GetAssetsToLoad(TArray<FSoftObjectPath>& OutPaths) const;
+};
@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "ChessCoreTypes.h"
+#include "ChessPieceTable.h"
 #include "ChessPieces.generated.h"
 
 UENUM(BlueprintType)
@@ -24,6 +26,17 @@ enum class ETeam : uint8
 	Black
 };
 
+// The Blueprint-facing enums mirror the ChessCore ones value for value.
+static_assert((uint8)EPieceType::King == (uint8)EChessPieceType::King, "EPieceType must match EChessPieceType");
+static_assert((uint8)ETeam::Black == (uint8)EChessColor::Black, "ETeam must match EChessColor");
+
+FORCEINLINE EChessPieceType ToChessPieceType(EPieceType Type) { return (EChessPieceType)Type; }
+FORCEINLINE EPieceType ToPieceType(EChessPieceType Type) { return (EPieceType)Type; }
+FORCEINLINE EChessColor ToChessColor(ETeam Team) { return (EChessColor)Team; }
+FORCEINLINE ETeam ToTeam(EChessColor Color) { return (ETeam)Color; }
+
+class AChessBoardActor;
+
 UCLASS()
 class CHESSGAME_API AChessPieces : public AActor
 {
@@ -35,23 +48,13 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ChessPiece")
 	UStaticMeshComponent* PieceMesh;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ChessPiece")
-	EPieceType PieceType;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ChessPiece")
-	ETeam Team;
-
-	UPROPERTY(BlueprintReadWrite, Category = "ChessPiece")
-	int32 BoardRow;
-
-	UPROPERTY(BlueprintReadWrite, Category = "ChessPiece")
-	int32 BoardCol;
+	/** Board whose piece table this actor shows. */
+	UPROPERTY(BlueprintReadOnly, Category = "ChessPiece")
+	AChessBoardActor* Board = nullptr;
 
-	UPROPERTY(BlueprintReadWrite)
-	bool bHasMoved; 
-
-	UPROPERTY(BlueprintReadWrite)
-	bool bJustDoubleMoved;
+	/** Index into the board's piece table. Everything else about the piece is read from there. */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ChessPiece")
+	int32 PieceId = INDEX_NONE;
 
 protected:
 	virtual void BeginPlay() override;
@@ -60,8 +63,27 @@ public:
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
 
-	void InitalizePiece(EPieceType InType, ETeam InTeam, UStaticMesh* InMesh);
-public:
-	FORCEINLINE EPieceType GetPieceType() const { return PieceType; }
+	void BindToBoard(AChessBoardActor* InBoard, int32 InPieceId);
+
+	UFUNCTION(BlueprintPure, Category = "ChessPiece")
+	EPieceType GetPieceType() const;
+
+	UFUNCTION(BlueprintPure, Category = "ChessPiece")
+	ETeam GetTeam() const;
+
+	UFUNCTION(BlueprintPure, Category = "ChessPiece")
+	int32 GetBoardRow() const;
+
+	UFUNCTION(BlueprintPure, Category = "ChessPiece")
+	int32 GetBoardCol() const;
+
+	UFUNCTION(BlueprintPure, Category = "ChessPiece")
+	bool HasMoved() const;
+
+	UFUNCTION(BlueprintPure, Category = "ChessPiece")
+	bool JustDoubleMoved() const;
+
+private:
+	const FChessPieceTable* GetTable() const;
 
 };
@@ -30,7 +30,21 @@ public:
 	FVector2D LastMoveStart;
 	FVector2D LastMoveEnd;
 
-	AChessPieces* EnPassantTarget = nullptr;
+	/** Console command: starts a new game, reusing the board's pooled pieces. */
+	UFUNCTION(Exec, BlueprintCallable, Category = "Chess")
+	void NewGame();
+
+	/** Console command: switches the board to one of its alternative piece sets. */
+	UFUNCTION(Exec, BlueprintCallable, Category = "Chess")
+	void UsePieceSet(int32 Index);
+
+	/** Console command: takes back the last move. */
+	UFUNCTION(Exec, BlueprintCallable, Category = "Chess")
+	void Undo();
+
+	/** Console command: shows or hides the engine's suggested moves on the board. */
+	UFUNCTION(Exec, BlueprintCallable, Category = "Chess")
+	void ToggleAnalysis();
 
 protected:
 	virtual void BeginPlay() override;
@@ -43,10 +57,6 @@ private:
 	bool IsValidMove(const FVector2D& TargetPosition);
 	void MoveSelectedPiece(const FVector2D& TargetPosition);
 
-	void MoveRookForCastle(int32 Row, int32 RookCol, int32 TargetCol);
-
-	void PromotePawn(AChessPieces* Pawn);
-
 	bool IsInCheck(ETeam Team);
 
 	bool IsCheckmate(ETeam Team);
@@ -0,0 +1,28 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+using System.Collections.Generic;
+
+[SupportedPlatforms(UnrealPlatformClass.Desktop)]
+public class ChessUCITarget : TargetRules
+{
+	public ChessUCITarget(TargetInfo Target) : base(Target)
+	{
+		Type = TargetType.Program;
+		LinkType = TargetLinkType.Monolithic;
+		DefaultBuildSettings = BuildSettingsVersion.V5;
+		IncludeOrderVersion = EngineIncludeOrderVersion.Unreal5_5;
+		LaunchModuleName = "ChessUCI";
+
+		// Console process speaking UCI over stdin/stdout. Links Core and ChessCore only,
+		// so it starts without the engine, UObject or editor data.
+		bIsBuildingConsoleApplication = true;
+		bCompileAgainstEngine = false;
+		bCompileAgainstCoreUObject = false;
+		bCompileAgainstApplicationCore = false;
+		bBuildWithEditorOnlyData = false;
+		bBuildDeveloperTools = false;
+		bCompileICU = false;
+		bUseMallocProfiler = false;
+	}
+}
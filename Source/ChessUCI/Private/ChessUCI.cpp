@@ -0,0 +1,33 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "RequiredProgramMainCPPInclude.h"
+#include "UciEngine.h"
+
+IMPLEMENT_APPLICATION(ChessUCI, "ChessUCI");
+
+INT32_MAIN_INT32_ARGC_TCHAR_ARGV()
+{
+	FTaskTagScope Scope(ETaskTag::EGameThread);
+	ON_SCOPE_EXIT
+	{
+		RequestEngineExit(TEXT("ChessUCI exiting"));
+		FEngineLoop::AppPreExit();
+		FModuleManager::Get().UnloadModulesAtShutdown();
+		FEngineLoop::AppExit();
+	};
+
+	// Core-only PreInit. Logging is silenced because stdout belongs to the UCI protocol.
+	if (int32 Ret = GEngineLoop.PreInit(ArgC, ArgV, TEXT(" -LogCmds=\"global off\"")))
+		return Ret;
+
+	FUciEngine Engine;
+
+	// "ChessUCI bench [depth]" runs the benchmark and exits, for scripts and CI.
+	if (ArgC > 1 && FCString::Stricmp(ArgV[1], TEXT("bench")) == 0)
+	{
+		Engine.RunBench(ArgC > 2 ? FCString::Atoi(ArgV[2]) : 0);
+		return 0;
+	}
+
+	return Engine.Run();
+}
@@ -0,0 +1,317 @@
+#include "UciEngine.h"
+#include "ChessMoveGenerator.h"
+#include "Async/Async.h"
+#include "HAL/PlatformTime.h"
+#include <stdio.h>
+
+namespace
+{
+	const int32 DefaultHashMB = 16;
+	const int32 MaxHashMB = 4096;
+	const int32 MaxThreads = 256;
+	const int32 MaxMultiPV = 64;
+	const int32 DefaultBenchDepth = 8;
+
+	// Keep a little time in hand for GUI and pipe latency.
+	const int32 MoveOverheadMs = 30;
+
+	const TCHAR* BenchPositions[] =
+	{
+		TEXT("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"),
+		TEXT("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"),
+		TEXT("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"),
+		TEXT("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1"),
+		TEXT("rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8"),
+		TEXT("r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10"),
+		TEXT("r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4"),
+		TEXT("6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1"),
+	};
+
+	int64 ParseInt(const TArray<FString>& Tokens, int32 Index, int64 Default)
+	{
+		return Tokens.IsValidIndex(Index) ? FCString::Atoi64(*Tokens[Index]) : Default;
+	}
+
+	FString FormatScore(int32 Score)
+	{
+		if (FChessSearch::IsMateScore(Score))
+			return FString::Printf(TEXT("mate %d"), FChessSearch::MateInMoves(Score));
+		return FString::Printf(TEXT("cp %d"), Score);
+	}
+}
+
+FUciEngine::FUciEngine()
+{
+	Search.SetHashSizeMB(DefaultHashMB);
+}
+
+FUciEngine::~FUciEngine()
+{
+	StopSearch();
+}
+
+int32 FUciEngine::Run()
+{
+	char Buffer[16384];
+	while (fgets(Buffer, sizeof(Buffer), stdin))
+	{
+		FString Line = UTF8_TO_TCHAR(Buffer);
+		Line.TrimStartAndEndInline();
+		if (!HandleCommand(Line))
+			break;
+	}
+
+	StopSearch();
+	return 0;
+}
+
+bool FUciEngine::HandleCommand(const FString& Line)
+{
+	TArray<FString> Tokens;
+	Line.ParseIntoArrayWS(Tokens);
+	if (Tokens.Num() == 0)
+		return true;
+
+	const FString& Command = Tokens[0];
+	if (Command == TEXT("uci"))
+	{
+		HandleUci();
+	}
+	else if (Command == TEXT("isready"))
+	{
+		Send(TEXT("readyok"));
+	}
+	else if (Command == TEXT("ucinewgame"))
+	{
+		StopSearch();
+		Search.ClearHash();
+		Match.Reset();
+	}
+	else if (Command == TEXT("setoption"))
+	{
+		StopSearch();
+		HandleSetOption(Tokens);
+	}
+	else if (Command == TEXT("position"))
+	{
+		StopSearch();
+		HandlePosition(Tokens);
+	}
+	else if (Command == TEXT("go"))
+	{
+		StopSearch();
+		HandleGo(Tokens);
+	}
+	else if (Command == TEXT("stop"))
+	{
+		StopSearch();
+	}
+	else if (Command == TEXT("bench"))
+	{
+		StopSearch();
+		RunBench((int32)ParseInt(Tokens, 1, 0));
+	}
+	else if (Command == TEXT("quit"))
+	{
+		StopSearch();
+		return false;
+	}
+	else
+	{
+		Send(FString::Printf(TEXT("info string unknown command: %s"), *Line));
+	}
+	return true;
+}
+
+void FUciEngine::HandleUci()
+{
+	Send(TEXT("id name ChessGame"));
+	Send(TEXT("id author ChessGame contributors"));
+	Send(FString::Printf(TEXT("option name Hash type spin default %d min 1 max %d"), DefaultHashMB, MaxHashMB));
+	Send(FString::Printf(TEXT("option name Threads type spin default 1 min 1 max %d"), MaxThreads));
+	Send(FString::Printf(TEXT("option name MultiPV type spin default 1 min 1 max %d"), MaxMultiPV));
+	Send(TEXT("uciok"));
+}
+
+void FUciEngine::HandleSetOption(const TArray<FString>& Tokens)
+{
+	// setoption name <id> [value <x>]; names may contain spaces.
+	FString Name;
+	FString Value;
+	FString* Current = nullptr;
+	for (int32 i = 1; i < Tokens.Num(); ++i)
+	{
+		if (Tokens[i] == TEXT("name"))
+			Current = &Name;
+		else if (Tokens[i] == TEXT("value"))
+			Current = &Value;
+		else if (Current)
+			*Current += (Current->IsEmpty() ? TEXT("") : TEXT(" ")) + Tokens[i];
+	}
+
+	if (Name.Equals(TEXT("Hash"), ESearchCase::IgnoreCase))
+		Search.SetHashSizeMB(FMath::Clamp(FCString::Atoi(*Value), 1, MaxHashMB));
+	else if (Name.Equals(TEXT("Threads"), ESearchCase::IgnoreCase))
+		Search.SetThreadCount(FMath::Clamp(FCString::Atoi(*Value), 1, MaxThreads));
+	else if (Name.Equals(TEXT("MultiPV"), ESearchCase::IgnoreCase))
+		MultiPV = FMath::Clamp(FCString::Atoi(*Value), 1, MaxMultiPV);
+	else
+		Send(FString::Printf(TEXT("info string unknown option: %s"), *Name));
+}
+
+void FUciEngine::HandlePosition(const TArray<FString>& Tokens)
+{
+	int32 Index = 1;
+	FString Fen = FChessPosition::StartFen;
+	if (Tokens.IsValidIndex(Index) && Tokens[Index] == TEXT("startpos"))
+	{
+		++Index;
+	}
+	else if (Tokens.IsValidIndex(Index) && Tokens[Index] == TEXT("fen"))
+	{
+		Fen.Reset();
+		for (++Index; Index < Tokens.Num() && Tokens[Index] != TEXT("moves"); ++Index)
+			Fen += Tokens[Index] + TEXT(" ");
+	}
+	else
+	{
+		return;
+	}
+
+	// A rejected position falls back to the start position rather than keeping the previous game.
+	if (!Match.ResetFromFen(Fen))
+	{
+		Send(FString::Printf(TEXT("info string error: invalid fen: %s"), *Fen));
+		Match.Reset();
+		return;
+	}
+
+	if (!Tokens.IsValidIndex(Index) || Tokens[Index] != TEXT("moves"))
+		return;
+
+	for (++Index; Index < Tokens.Num(); ++Index)
+	{
+		const FChessMove Move = FChessMoveGenerator::ParseUciMove(Match.GetPosition(), Tokens[Index]);
+		if (Move.IsNull() || !Match.MakeMove(Move))
+		{
+			// Never search a half-applied move list; go back to where the command started.
+			Send(FString::Printf(TEXT("info string error: illegal move: %s"), *Tokens[Index]));
+			verify(Match.ResetFromFen(Fen));
+			return;
+		}
+	}
+}
+
+void FUciEngine::HandleGo(const TArray<FString>& Tokens)
+{
+	FChessSearchLimits Limits;
+	Limits.MultiPV = MultiPV;
+	int64 TimeLeft[2] = { 0, 0 };
+	int64 Increment[2] = { 0, 0 };
+	int64 MovesToGo = 0;
+
+	for (int32 i = 1; i < Tokens.Num(); ++i)
+	{
+		const FString& Token = Tokens[i];
+		if (Token == TEXT("depth"))          Limits.Depth = (int32)ParseInt(Tokens, ++i, 0);
+		else if (Token == TEXT("movetime"))  Limits.MoveTimeMs = (int32)ParseInt(Tokens, ++i, 0);
+		else if (Token == TEXT("nodes"))     Limits.Nodes = (uint64)ParseInt(Tokens, ++i, 0);
+		else if (Token == TEXT("infinite"))  Limits.bInfinite = true;
+		else if (Token == TEXT("wtime"))     TimeLeft[0] = ParseInt(Tokens, ++i, 0);
+		else if (Token == TEXT("btime"))     TimeLeft[1] = ParseInt(Tokens, ++i, 0);
+		else if (Token == TEXT("winc"))      Increment[0] = ParseInt(Tokens, ++i, 0);
+		else if (Token == TEXT("binc"))      Increment[1] = ParseInt(Tokens, ++i, 0);
+		else if (Token == TEXT("movestogo")) MovesToGo = ParseInt(Tokens, ++i, 0);
+	}
+
+	// Clock-based games (cutechess-cli, GUIs) get a simple slice of the remaining time.
+	const int32 Us = (int32)Match.GetSideToMove();
+	if (!Limits.bInfinite && Limits.MoveTimeMs == 0 && TimeLeft[Us] > 0)
+	{
+		const int64 Slice = TimeLeft[Us] / (MovesToGo > 0 ? MovesToGo : 30) + Increment[Us] * 3 / 4;
+		Limits.MoveTimeMs = (int32)FMath::Clamp<int64>(Slice - MoveOverheadMs, 1, FMath::Max<int64>(1, TimeLeft[Us] - MoveOverheadMs));
+	}
+
+	const FChessPosition Root = Match.GetPosition();
+	const TArray<uint64> RootHistory = Match.GetHashHistory();
+
+	// Armed here rather than on the worker, so a "stop" that arrives before the thread runs still counts.
+	Search.BeginSearch();
+	SearchTask = Async(EAsyncExecution::Thread, [this, Root, RootHistory, Limits]()
+		{
+			const FChessSearchResult Result = Search.Search(Root, RootHistory, Limits,
+				[this](const FChessSearchInfo& Info) { SendInfo(Info); });
+
+			FString Line = TEXT("bestmove ") + Result.BestMove.ToUci();
+			if (!Result.PonderMove.IsNull())
+				Line += TEXT(" ponder ") + Result.PonderMove.ToUci();
+			Send(Line);
+		});
+}
+
+void FUciEngine::RunBench(int32 Depth)
+{
+	const int32 SavedThreads = Search.GetThreadCount();
+	Search.SetThreadCount(1);
+
+	FChessSearchLimits Limits;
+	Limits.Depth = Depth > 0 ? Depth : DefaultBenchDepth;
+
+	uint64 TotalNodes = 0;
+	double TotalSeconds = 0.0;
+	for (const TCHAR* Fen : BenchPositions)
+	{
+		FChessPosition BenchPosition;
+		BenchPosition.SetFromFen(Fen);
+		Search.ClearHash();
+
+		Search.BeginSearch();
+		const FChessSearchResult Result = Search.Search(BenchPosition, TArray<uint64>(), Limits);
+		TotalNodes += Result.Nodes;
+		TotalSeconds += Result.ElapsedSeconds;
+		Send(FString::Printf(TEXT("info string bench %s bestmove %s nodes %llu"), Fen, *Result.BestMove.ToUci(), Result.Nodes));
+	}
+
+	Search.SetThreadCount(SavedThreads);
+	Search.ClearHash();
+
+	const uint64 ElapsedMs = FMath::Max<uint64>(1, (uint64)(TotalSeconds * 1000.0));
+	Send(FString::Printf(TEXT("Total time (ms) : %llu"), ElapsedMs));
+	Send(FString::Printf(TEXT("Nodes searched  : %llu"), TotalNodes));
+	Send(FString::Printf(TEXT("Nodes/second    : %llu"), TotalNodes * 1000 / ElapsedMs));
+}
+
+void FUciEngine::StopSearch()
+{
+	Search.Stop();
+	WaitForSearch();
+}
+
+void FUciEngine::WaitForSearch()
+{
+	if (SearchTask.IsValid())
+	{
+		SearchTask.Wait();
+		SearchTask.Reset();
+	}
+}
+
+void FUciEngine::SendInfo(const FChessSearchInfo& Info)
+{
+	const uint64 ElapsedMs = (uint64)(Info.ElapsedSeconds * 1000.0);
+	const uint64 Nps = (uint64)(Info.Nodes / FMath::Max(Info.ElapsedSeconds, 0.001));
+
+	FString Line = FString::Printf(TEXT("info depth %d seldepth %d multipv %d score %s nodes %llu nps %llu hashfull %d time %llu pv"),
+		Info.Depth, Info.SelDepth, Info.MultiPVIndex, *FormatScore(Info.Score), Info.Nodes, Nps, Info.HashFullPermill, ElapsedMs);
+	for (const FChessMove& Move : Info.PrincipalVariation)
+		Line += TEXT(" ") + Move.ToUci();
+	Send(Line);
+}
+
+void FUciEngine::Send(const FString& Line)
+{
+	FScopeLock Lock(&OutputLock);
+	fputs(TCHAR_TO_UTF8(*Line), stdout);
+	fputc('\n', stdout);
+	fflush(stdout);
+}
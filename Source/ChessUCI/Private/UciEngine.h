@@ -0,0 +1,46 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ChessMatch.h"
+#include "ChessSearch.h"
+#include "Async/Future.h"
+#include "HAL/CriticalSection.h"
+
+/**
+ * Universal Chess Interface front end for FChessSearch. Commands are read on the calling
+ * thread; searches run on a worker thread so "stop" and "isready" stay responsive.
+ */
+class FUciEngine
+{
+public:
+	FUciEngine();
+	~FUciEngine();
+
+	/** Reads commands from stdin until "quit" or end of input. */
+	int32 Run();
+
+	/** Handles a single command line. Returns false when the engine should exit. */
+	bool HandleCommand(const FString& Line);
+
+	/** Fixed-depth search over a built-in position set, reporting total nodes and speed. Depth 0 uses the default. */
+	void RunBench(int32 Depth);
+
+private:
+	void HandleUci();
+	void HandleSetOption(const TArray<FString>& Tokens);
+	void HandlePosition(const TArray<FString>& Tokens);
+	void HandleGo(const TArray<FString>& Tokens);
+
+	void StopSearch();
+	void WaitForSearch();
+
+	void SendInfo(const FChessSearchInfo& Info);
+	void Send(const FString& Line);
+
+	FChessSearch Search;
+	FChessMatch Match;
+	int32 MultiPV = 1;
+
+	TFuture<void> SearchTask;
+	FCriticalSection OutputLock;
+};